@@ -0,0 +1,25 @@
+#version 430 core
+#extension GL_ARB_shader_draw_parameters : require
+
+layout(location = 0) in vec3 vertexPosition_modelspace;
+layout(location = 1) in vec3 vertexColor;
+
+layout(std140) uniform CameraBlock {
+    mat4 ViewProjection;
+    mat4 View;
+    mat4 Projection;
+    vec4 CameraPosition;
+};
+
+// the transforms of the draws of one multi draw call, bound to a range
+// of the IndirectRenderer's transform buffer so the draw ID indexes it
+layout(std430) readonly buffer TransformBlock {
+    mat4 Transforms[];
+};
+
+out vec3 fragmentColor;
+
+void main() {
+    gl_Position = ViewProjection*Transforms[gl_DrawIDARB]*vec4(vertexPosition_modelspace, 1);
+    fragmentColor = vertexColor;
+}
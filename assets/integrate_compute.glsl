@@ -0,0 +1,67 @@
+#version 430 core
+
+layout(local_size_x = 64) in;
+
+// the state of the bodies, w is unused, bound to the binding points of
+// the ComputeIntegrator
+layout(std430) buffer PositionBlock {
+    vec4 Positions[];
+};
+
+layout(std430) buffer PreviousPositionBlock {
+    vec4 PreviousPositions[];
+};
+
+layout(std430) buffer VelocityBlock {
+    vec4 Velocities[];
+};
+
+layout(std430) readonly buffer AccelerationBlock {
+    vec4 Accelerations[];
+};
+
+// read as the per-instance transform attribute of the instanced draw
+layout(std430) writeonly buffer InstanceTransformBlock {
+    mat4 InstanceTransforms[];
+};
+
+uniform uint BodyCount;
+uniform uint Steps;
+uniform float Timestep;
+uniform float Alpha;
+
+void main() {
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= BodyCount) {
+        return;
+    }
+
+    // precise keeps the compiler from fusing or reordering the operations,
+    // so the steps round exactly like Object::update
+    precise vec3 position = Positions[index].xyz;
+    precise vec3 previous = PreviousPositions[index].xyz;
+    precise vec3 velocity = Velocities[index].xyz;
+    vec3 acceleration = Accelerations[index].xyz;
+    precise float half_dt = 0.5*Timestep;
+
+    for (uint step = 0; step < Steps; step++) {
+        previous = position;
+        velocity += half_dt*acceleration;
+        position += Timestep*velocity;
+        velocity += half_dt*acceleration;
+
+        // fake a floor
+        precise float moving_down = velocity.y*position.y;
+        if ((position.y < 0.0) && (moving_down > 0.0)) {
+            velocity.y *= -0.9;
+        }
+    }
+
+    Positions[index].xyz = position;
+    PreviousPositions[index].xyz = previous;
+    Velocities[index].xyz = velocity;
+
+    // the same blend as glm::mix in Object::interpolate
+    precise vec3 interpolated = previous*(1.0 - Alpha) + position*Alpha;
+    InstanceTransforms[index] = mat4(vec4(1, 0, 0, 0), vec4(0, 1, 0, 0), vec4(0, 0, 1, 0), vec4(interpolated, 1));
+}
@@ -2,13 +2,27 @@
 
 layout(location = 0) in vec3 vertexPosition_modelspace;
 layout(location = 1) in vec3 vertexColor;
+// per-instance transform, used in place of ModelTransform when Instanced is set
+layout(location = 2) in mat4 InstanceTransform;
 
-uniform mat4 CameraTransform;
-uniform mat4 ModelTransform;
+// the blocks are bound to the shared uniform buffers when the program is
+// loaded, see UniformBuffers, so switching programs needs no uploads
+layout(std140) uniform CameraBlock {
+    mat4 ViewProjection;
+    mat4 View;
+    mat4 Projection;
+    vec4 CameraPosition;
+};
+
+layout(std140) uniform DrawBlock {
+    mat4 ModelTransform;
+    bool Instanced;
+};
 
 out vec3 fragmentColor;
 
 void main() {
-    gl_Position = CameraTransform*ModelTransform*vec4(vertexPosition_modelspace, 1);
+    mat4 ModelToWorld = Instanced ? InstanceTransform : ModelTransform;
+    gl_Position = ViewProjection*ModelToWorld*vec4(vertexPosition_modelspace, 1);
     fragmentColor = vertexColor;
 }
@@ -0,0 +1,94 @@
+#include <string>
+#include <vector>
+
+#include "core/arena.h"
+#include "core/mesh.h"
+#include "bench_util.h"
+
+static void gridFunction(glm::vec2 unit_pos, glm::vec3& position, glm::vec3& color) {
+    position = glm::vec3(unit_pos.x, 0.f, unit_pos.y);
+    color = glm::vec3(unit_pos.x, unit_pos.y, 0.f);
+}
+
+/// Fills the staging buffers of a grid mesh, the same work whichever
+/// allocator the buffers came from.
+static void fillGrid(int resolution, GLfloat* vertices, GLuint* indices, size_t index_count) {
+    evaluateGrid(resolution, resolution, gridFunction, vertices);
+    for (size_t i = 0; i < index_count; i++) {
+        indices[i] = static_cast<GLuint>(i);
+    }
+    doNotOptimize(vertices[0]);
+    doNotOptimize(indices[0]);
+}
+
+static size_t gridIndexCount(int resolution) {
+    return 6*static_cast<size_t>((resolution - 1)*(resolution - 1));
+}
+
+/// Stages a grid mesh in the arena and resets it, like the mesh
+/// initializers do for every model.
+static void stageArena(Arena& arena, int resolution) {
+    size_t index_count = gridIndexCount(resolution);
+    GLfloat* vertices = arena.allocate<GLfloat>(6*static_cast<size_t>(resolution*resolution));
+    GLuint* indices = arena.allocate<GLuint>(index_count);
+    fillGrid(resolution, vertices, indices, index_count);
+    arena.reset();
+}
+
+/// Stages the same mesh in vectors that are freed afterwards.
+static void stageVector(int resolution) {
+    size_t index_count = gridIndexCount(resolution);
+    std::vector<GLfloat> vertices(6*static_cast<size_t>(resolution*resolution));
+    std::vector<GLuint> indices(index_count);
+    fillGrid(resolution, vertices.data(), indices.data(), index_count);
+}
+
+int main() {
+    std::cout << "Mesh staging, one grid mesh per item\n";
+    for (int resolution : {32, 100, 1000}) {
+        int models = (resolution >= 1000) ? 4 : 64;
+        Arena arena = Arena();
+        double arena_time = bestTime(10, [&]() {
+            for (int i = 0; i < models; i++) {
+                stageArena(arena, resolution);
+            }
+        });
+        double vector_time = bestTime(10, [&]() {
+            for (int i = 0; i < models; i++) {
+                stageVector(resolution);
+            }
+        });
+        std::string grid = std::to_string(resolution) + "x" + std::to_string(resolution);
+        printResult("  Arena " + grid, arena_time, models);
+        printResult("  std::vector " + grid, vector_time, models);
+    }
+
+    // many small transient allocations, where a bump allocator saves the
+    // most over the general purpose allocator
+    constexpr int allocations = 1 << 14;
+    std::cout << "Small allocations, one allocation per item\n";
+    for (size_t size : {size_t(64), size_t(256), size_t(4096)}) {
+        Arena arena = Arena();
+        double arena_time = bestTime(20, [&]() {
+            for (int i = 0; i < allocations; i++) {
+                unsigned char* data = arena.allocate<unsigned char>(size);
+                data[0] = static_cast<unsigned char>(i);
+                doNotOptimize(data[0]);
+            }
+            arena.reset();
+        });
+        std::vector<std::vector<unsigned char>> buffers;
+        buffers.reserve(allocations);
+        double vector_time = bestTime(20, [&]() {
+            for (int i = 0; i < allocations; i++) {
+                buffers.emplace_back(size);
+                buffers.back()[0] = static_cast<unsigned char>(i);
+                doNotOptimize(buffers.back()[0]);
+            }
+            buffers.clear();
+        });
+        printResult("  Arena " + std::to_string(size) + " bytes", arena_time, allocations);
+        printResult("  std::vector " + std::to_string(size) + " bytes", vector_time, allocations);
+    }
+    return 0;
+}
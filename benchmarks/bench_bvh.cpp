@@ -0,0 +1,77 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+
+#include "core/bounds.h"
+#include "core/bvh.h"
+#include "core/frustum.h"
+#include "bench_util.h"
+
+/// Scatters small boxes through a cube around the origin, the objects
+/// of a large scene.
+static std::vector<Bounds> scatterBounds(size_t count, float size) {
+    std::mt19937 random(12345);
+    std::uniform_real_distribution<float> position(-size, size);
+    std::uniform_real_distribution<float> extent(0.05f, 2.f);
+    std::vector<Bounds> bounds(count);
+    for (Bounds& object : bounds) {
+        BoundingBox box;
+        box.m_min = glm::vec3(position(random), position(random), position(random));
+        box.m_max = box.m_min + glm::vec3(extent(random), extent(random), extent(random));
+        object = boundsFromBox(box);
+    }
+    return bounds;
+}
+
+/// Tests every object with the same tests as the leaves of the hierarchy.
+static void bruteForceCull(const Frustum& frustum, const std::vector<Bounds>& bounds, std::vector<std::uint32_t>& visible) {
+    visible.clear();
+    for (size_t i = 0; i < bounds.size(); i++) {
+        if (frustum.intersects(bounds[i].m_sphere) && (frustum.classify(bounds[i].m_box) != Frustum::OUTSIDE)) {
+            visible.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+}
+
+/// Culls a scene seen from its edge, so the camera sees part of it, with
+/// the hierarchy and by testing every object.
+static void benchmarkScene(size_t count, float size) {
+    std::vector<Bounds> bounds = scatterBounds(count, size);
+    BoundingVolumeHierarchy bvh = BoundingVolumeHierarchy();
+    bvh.update(bounds);
+
+    glm::mat4 view = glm::lookAt(glm::vec3(0.f, 0.f, 1.2f*size), glm::vec3(0.3f*size, 0.f, 0.f), glm::vec3(0.f, 1.f, 0.f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.f), 16.f/9.f, 0.1f, 2.f*size);
+    Frustum frustum = Frustum(projection*view);
+
+    std::vector<std::uint32_t> visible;
+    visible.reserve(count);
+    double bvh_time = bestTime(20, [&]() {
+        bvh.cull(frustum, visible);
+        doNotOptimize(visible.data());
+    });
+    size_t visible_count = visible.size();
+    double brute_force_time = bestTime(20, [&]() {
+        bruteForceCull(frustum, bounds, visible);
+        doNotOptimize(visible.data());
+    });
+    double refit_time = bestTime(20, [&]() {
+        bvh.update(bounds);
+    });
+
+    double items = static_cast<double>(count);
+    std::cout << count << " objects, " << visible_count << " visible\n";
+    printResult("  BoundingVolumeHierarchy::cull", bvh_time, items);
+    printResult("  brute force frustum test", brute_force_time, items);
+    printResult("  BoundingVolumeHierarchy::update", refit_time, items);
+}
+
+int main() {
+    benchmarkScene(1000, 30.f);
+    benchmarkScene(10000, 100.f);
+    benchmarkScene(100000, 300.f);
+    return 0;
+}
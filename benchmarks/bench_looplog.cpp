@@ -0,0 +1,83 @@
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "core/looplog.h"
+#include "bench_util.h"
+
+constexpr int lines = 1 << 14;
+/// Lines logged between two reads of the ring, about a frame's worth.
+constexpr int lines_per_frame = 64;
+
+/// Marks everything written to a ring as read, the part of the writer
+/// thread that frees room in the ring without printing anything.
+static void drainRing(LogRing* ring) {
+    if (ring != nullptr) {
+        ring->m_read.store(ring->m_committed.load(std::memory_order_acquire), std::memory_order_release);
+    }
+}
+
+/// Logs a line like the profiler's zone statistics.
+template<typename Stream>
+static void logLine(Stream& stream, int i) {
+    stream << "  Zone " << i << ": " << 0.001*static_cast<double>(i) << " | " << 1.f << "\n";
+}
+
+/// Logs from a thread that gets no ring, once every ring is taken.
+static double timeWithoutRing(LoopLog* loopLog) {
+    double time = 0.0;
+    std::thread thread([&]() {
+        time = bestTime(20, [&]() {
+            for (int i = 0; i < lines; i++) {
+                logLine(loopLog->m_log, i);
+            }
+        });
+    });
+    thread.join();
+    return time;
+}
+
+int main() {
+    LoopLog* loopLog = LoopLog::getInstance();
+    LogRing* ring = loopLog->threadRing();
+
+    std::cout << "Logging, one formatted line per item\n";
+    double loop_log_time = bestTime(20, [&]() {
+        for (int i = 0; i < lines; i++) {
+            logLine(loopLog->m_log, i);
+            if (i % lines_per_frame == 0) {
+                drainRing(ring);
+            }
+        }
+        drainRing(ring);
+    });
+    std::ostringstream stream;
+    double stream_time = bestTime(20, [&]() {
+        for (int i = 0; i < lines; i++) {
+            logLine(stream, i);
+            if (i % lines_per_frame == 0) {
+                stream.str(std::string());
+            }
+        }
+        stream.str(std::string());
+    });
+
+    // take every ring, so the next thread has to do without one
+    while (true) {
+        bool has_ring = true;
+        std::thread thread([&]() {
+            has_ring = (loopLog->threadRing() != nullptr);
+        });
+        thread.join();
+        if (!has_ring) {
+            break;
+        }
+    }
+    double no_ring_time = timeWithoutRing(loopLog);
+
+    printResult("  LoopLog", loop_log_time, lines);
+    printResult("  std::ostringstream", stream_time, lines);
+    printResult("  LoopLog, thread without a ring", no_ring_time, lines);
+    loopLog->close();
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <cmath>
+#include <vector>
+
+#include "core/object.h"
+#include "core/physics_world.h"
+#include "bench_util.h"
+
+/// The goal is to step this many bodies and build their transforms on
+/// one core within a 60 Hz frame.
+constexpr size_t target_bodies = 1000000;
+constexpr double frame_budget = 1.0/60.0;
+constexpr float timestep = 1.f/120.f;
+
+int main() {
+    PhysicsWorld world = PhysicsWorld();
+    std::vector<Object> objects;
+    objects.reserve(target_bodies);
+    for (size_t i = 0; i < target_bodies; i++) {
+        float phase = static_cast<float>(i);
+        glm::vec3 position = glm::vec3(std::sin(phase), 1.f + std::cos(phase), 0.f);
+        glm::vec3 velocity = glm::vec3(0.f, 5.f*std::sin(0.3f*phase), 0.f);
+        glm::vec3 acceleration = glm::vec3(0.f, -9.81f, 0.f);
+        world.addBody(position, velocity, acceleration);
+
+        objects.emplace_back(ModelHandle());
+        objects.back().m_position = position;
+        objects.back().m_velocity = velocity;
+        objects.back().m_acceleration = acceleration;
+    }
+
+    const char* kernel = "scalar";
+#if defined(__AVX__)
+    kernel = "AVX";
+#elif defined(__SSE2__)
+    kernel = "SSE";
+#endif
+    std::cout << "Integrating " << target_bodies << " bodies on one core, " << kernel << " kernel\n";
+
+    double step_time = bestTime(10, [&]() {
+        world.step(timestep);
+        doNotOptimize(world.m_positionY[0]);
+    });
+    double transform_time = bestTime(10, [&]() {
+        world.buildTransforms();
+        doNotOptimize(world.m_transforms[0]);
+    });
+    double object_time = bestTime(10, [&]() {
+        for (Object& object : objects) {
+            object.update(timestep);
+        }
+        doNotOptimize(objects[0].m_position);
+    });
+
+    double items = static_cast<double>(target_bodies);
+    printResult("  PhysicsWorld::step", step_time, items);
+    printResult("  PhysicsWorld::buildTransforms", transform_time, items);
+    printResult("  PhysicsWorld step and transforms", step_time + transform_time, items);
+    printResult("  Object::update", object_time, items);
+
+    double frame_time = step_time + transform_time;
+    std::cout << std::setprecision(2) << "  " << 1e3*frame_time << " ms per frame for " << target_bodies << " bodies, "
+              << (frame_time <= frame_budget ? "within" : "over") << " the " << 1e3*frame_budget << " ms budget\n";
+    return 0;
+}
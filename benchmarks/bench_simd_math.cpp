@@ -0,0 +1,95 @@
+#include <cmath>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "core/job_system.h"
+#include "core/mesh.h"
+#include "core/parametric.h"
+#include "core/simd_math.h"
+#include "bench_util.h"
+
+/// The torus of the scene, with the standard library's sine and cosine.
+static void scalarTorus(glm::vec2 unit_pos, glm::vec3& position, glm::vec3& color) {
+    float theta = 6.28f*unit_pos.x, phi = 6.28f*unit_pos.y;
+    float radius = 1.0f + 0.5f*std::cos(theta);
+    position = glm::vec3(radius*std::cos(phi), 0.5f*std::sin(theta), radius*std::sin(phi));
+    color = glm::vec3(unit_pos.x, unit_pos.y, 0.0f);
+}
+
+/// The same torus with the vector math of `simd_math.h`.
+static void simdTorus(Float4 u, Float4 v, Float4 position[3], Float4 color[3]) {
+    Float4 sin_theta, cos_theta, sin_phi, cos_phi;
+    simdSinCos(6.28f*u, sin_theta, cos_theta);
+    simdSinCos(6.28f*v, sin_phi, cos_phi);
+
+    Float4 radius = 1.0f + 0.5f*cos_theta;
+    position[0] = radius*cos_phi;
+    position[1] = 0.5f*sin_theta;
+    position[2] = radius*sin_phi;
+    color[0] = u;
+    color[1] = v;
+    color[2] = 0.0f;
+}
+
+/// The gaussian surface of the scene, with the standard library's
+/// exponential.
+static void scalarGaussian(glm::vec2 unit_pos, glm::vec3& position, glm::vec3& color) {
+    float x = 5.f*(unit_pos.x - 0.5f), y = 5.f*(unit_pos.y - 0.5f);
+    float height = std::exp(-(x*x + y*y));
+    position = glm::vec3(x, height, y);
+    color = glm::vec3(unit_pos.x, unit_pos.y, height);
+}
+
+/// The same surface with the vector math of `simd_math.h`.
+static void simdGaussian(Float4 u, Float4 v, Float4 position[3], Float4 color[3]) {
+    Float4 x = 5.f*(u - 0.5f);
+    Float4 y = 5.f*(v - 0.5f);
+    Float4 height = simdExp(-(x*x + y*y));
+
+    position[0] = x;
+    position[1] = height;
+    position[2] = y;
+    color[0] = u;
+    color[1] = v;
+    color[2] = height;
+}
+
+/// Evaluates a surface with the scalar `evaluateGrid()`, and with
+/// `evaluateParametricGrid()` on the calling thread alone and on every
+/// core.
+template<typename ScalarFunction, typename SimdFunction>
+static void benchmarkSurface(const std::string& name, int resolution, ScalarFunction scalar, SimdFunction simd) {
+    std::vector<GLfloat> vertices(6*static_cast<size_t>(resolution)*static_cast<size_t>(resolution));
+    JobSystem single_thread = JobSystem(0);
+    JobSystem all_threads = JobSystem();
+
+    double scalar_time = bestTime(10, [&]() {
+        evaluateGrid(resolution, resolution, scalar, vertices.data());
+        doNotOptimize(vertices.data());
+    });
+    double simd_time = bestTime(10, [&]() {
+        evaluateParametricGrid(resolution, resolution, simd, vertices.data(), single_thread);
+        doNotOptimize(vertices.data());
+    });
+    double parallel_time = bestTime(10, [&]() {
+        evaluateParametricGrid(resolution, resolution, simd, vertices.data(), all_threads);
+        doNotOptimize(vertices.data());
+    });
+
+    double items = static_cast<double>(resolution)*resolution;
+    std::cout << name << " " << resolution << "x" << resolution << " grid, " << all_threads.threadCount() + 1 << " threads\n";
+    printResult("  evaluateGrid", scalar_time, items);
+    printResult("  evaluateParametricGrid, one thread", simd_time, items);
+    printResult("  evaluateParametricGrid, all threads", parallel_time, items);
+}
+
+int main() {
+    for (int resolution : {100, 1000}) {
+        benchmarkSurface("Torus", resolution, scalarTorus, simdTorus);
+        benchmarkSurface("Gaussian", resolution, scalarGaussian, simdGaussian);
+    }
+    return 0;
+}
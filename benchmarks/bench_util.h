@@ -0,0 +1,59 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/// Keeps the compiler from optimizing away the computation of a value
+/// or the writes to the memory it points to.
+template<typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const volatile T* sink;
+    sink = &value;
+#endif
+}
+
+/// Runs a function a number of times after one warm up run.
+/// @return Time in seconds of the fastest run, which is the least
+/// disturbed by the rest of the system.
+template<typename Function>
+double bestTime(int repetitions, Function function) {
+    function();
+    double best = 0.0;
+    for (int i = 0; i < repetitions; i++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        function();
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if ((i == 0) || (time < best)) {
+            best = time;
+        }
+    }
+    return best;
+}
+
+/// Prints one line of results, the time per item and the items per
+/// second.
+inline void printResult(const std::string& name, double seconds, double items) {
+    double per_item = seconds/items;
+    const char* unit = " s";
+    if (per_item < 1e-6) {
+        per_item *= 1e9;
+        unit = " ns";
+    } else if (per_item < 1e-3) {
+        per_item *= 1e6;
+        unit = " us";
+    } else if (per_item < 1.0) {
+        per_item *= 1e3;
+        unit = " ms";
+    }
+    std::cout << std::left << std::setw(40) << name << std::right
+              << std::setw(10) << std::fixed << std::setprecision(2) << per_item << unit << "/item"
+              << std::setw(14) << std::setprecision(0) << items/seconds << " items/s\n";
+}
+
+#endif
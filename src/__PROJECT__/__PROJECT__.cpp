@@ -1,5 +1,15 @@
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 // keep this before all other OpenGL libraries
 #define GLEW_STATIC
@@ -9,10 +19,34 @@
 
 #include "core/looplog.h"
 #include "core/frame_timer.h"
+#include "core/fixed_step.h"
+#include "core/frame_pacer.h"
+#include "core/arena.h"
+#include "core/mesh.h"
+#include "core/mesh_cache.h"
+#include "core/parametric.h"
+#include "core/hash.h"
 #include "core/model.h"
+#include "core/lod.h"
+#include "core/stream_buffer.h"
+#include "core/geometry_pool.h"
+#include "core/uniform_buffers.h"
 #include "core/object.h"
+#include "core/physics_world.h"
+#include "core/compute_integrator.h"
+#include "core/frustum.h"
+#include "core/bvh.h"
+#include "core/batch_renderer.h"
+#include "core/render_queue.h"
+#include "core/indirect_renderer.h"
+#include "core/job_system.h"
+#include "core/render_stats.h"
+#include "core/profiler.h"
+#include "core/gpu_timer.h"
 #include "core/camera.h"
+#include "core/headless_context.h"
 #include "core/shaders.h"
+#include "core/shader_manager.h"
 #include "core/path_util.h"
 
 void Controlls(float dt, GLFWwindow* window, Camera &camera) {
@@ -59,212 +93,700 @@ void Controlls(float dt, GLFWwindow* window, Camera &camera) {
     camera.m_position += delta_position;
 }
 
-glm::vec2 meshgrid(int x_resolution, int y_resolution, int vertex_index) {
-    int triangle_index = vertex_index / 3; // index of the triangle
-    int triangle_vertex_index = vertex_index % 3; // label of the vertex within the triangle
+/// Moves the camera along a fixed path so headless runs render the same
+/// frames every time. The camera circles the scene while bobbing up and
+/// down and always looks at the middle of the scene.
+void scriptedCamera(float time, Camera &camera) {
+    const glm::vec3 target = glm::vec3(0.f, 0.f, -1.5f);
+    float angle = 0.5f*time;
 
-    int quad_index = triangle_index / 2; // index of the quad
-    int quad_triangle_index = triangle_index % 2; // label of the triangle within the quad
-
-    int column_index = quad_index / (x_resolution - 1); // index of the column
-    int row_index = quad_index % (x_resolution - 1); // index of the row
-
-    // lower left coordinate of triangle on the unit square
-    glm::vec2 unit_pos;
-    unit_pos.x = static_cast<float>(row_index)/static_cast<float>(x_resolution - 1);
-    unit_pos.y = static_cast<float>(column_index)/static_cast<float>(y_resolution - 1);
+    camera.m_position = target + glm::vec3(8.f*std::sin(angle), 3.f + std::sin(0.7f*time), 8.f*std::cos(angle));
+    camera.m_direction = glm::normalize(target - camera.m_position);
+    camera.m_up = glm::vec3(0.f, 1.f, 0.f);
+}
 
-    // offset for the upper right vertex
-    if (triangle_vertex_index == 1) {
-        unit_pos.x += 1.0f/static_cast<float>(x_resolution - 1);
-        unit_pos.y += 1.0f/static_cast<float>(y_resolution - 1);
+/// How the visible objects are submitted each frame.
+enum Submission {
+    /// Sorted by state with a `RenderQueue`, one draw per object.
+    QUEUE_SUBMISSION,
+    /// Grouped by model with a `BatchRenderer`, one instanced draw per model.
+    BATCH_SUBMISSION,
+    /// Grouped by vertex array with an `IndirectRenderer`, one multi draw
+    /// indirect call per program and vertex array.
+    INDIRECT_SUBMISSION
+};
+
+const char* submissionName(Submission submission) {
+    switch (submission) {
+    case BATCH_SUBMISSION:
+        return "batch";
+    case INDIRECT_SUBMISSION:
+        return "indirect";
+    default:
+        return "queue";
     }
+}
+
+struct Options {
+    bool m_headless = false;
+    int m_frames = 600;
+    float m_timestep = 1.f/60.f;
+    double m_tickRate = 120.0;
+    double m_frameRate = 60.0;
+    Submission m_submission = QUEUE_SUBMISSION;
+    int m_particles = 0;
+    std::string m_output = "benchmark.json";
+    /// Where to write the profiler trace, empty to not record one.
+    std::string m_trace;
+};
+
+void printUsage(const char* name) {
+    std::cerr << "Usage: " << name << " [--headless] [--frames N] [--timestep SECONDS] [--tick-rate HZ]"
+              << " [--frame-rate HZ] [--submission queue|batch|indirect] [--particles N] [--output PATH]"
+              << " [--trace PATH]\n"
+              << "  --headless          render offscreen without a window for a fixed number of frames\n"
+              << "  --frames N          number of frames to render in headless mode, default 600\n"
+              << "  --timestep SECONDS  fixed frame time step in headless mode, default 1/60\n"
+              << "  --tick-rate HZ      simulation steps per second, independent of the frame rate, default 120\n"
+              << "  --frame-rate HZ     frame rate the window is paced to, 0 for uncapped, default 60, headless runs are not paced\n"
+              << "  --submission MODE   queue to sort the draws by state, batch to instance them by model,\n"
+              << "                      indirect for one multi draw indirect call per vertex array, default queue\n"
+              << "  --particles N       number of bouncing spheres integrated by a compute shader, default 0\n"
+              << "  --output PATH       where to write the headless frame time statistics, default benchmark.json\n"
+              << "  --trace PATH        record the latest profiler zones and write them as a Chrome trace on exit,\n"
+              << "                      needs the ENABLE_PROFILER build option\n";
+}
 
-    // offsets for the off diagonal vertex. The spesific offset
-    // is dependent on if it is the upper or lower triangle
-    if (triangle_vertex_index == 2){
-        if (quad_triangle_index == 0) {
-            unit_pos.x += 1.0f/static_cast<float>(x_resolution - 1);
+/// @return False if the arguments are invalid.
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        const char* argument = argv[i];
+        bool has_value = (i + 1 < argc);
+        if (std::strcmp(argument, "--headless") == 0) {
+            options.m_headless = true;
+        } else if ((std::strcmp(argument, "--frames") == 0) && has_value) {
+            options.m_frames = std::atoi(argv[++i]);
+        } else if ((std::strcmp(argument, "--timestep") == 0) && has_value) {
+            options.m_timestep = static_cast<float>(std::atof(argv[++i]));
+        } else if ((std::strcmp(argument, "--tick-rate") == 0) && has_value) {
+            options.m_tickRate = std::atof(argv[++i]);
+        } else if ((std::strcmp(argument, "--frame-rate") == 0) && has_value) {
+            options.m_frameRate = std::atof(argv[++i]);
+        } else if ((std::strcmp(argument, "--submission") == 0) && has_value) {
+            const char* mode = argv[++i];
+            if (std::strcmp(mode, "queue") == 0) {
+                options.m_submission = QUEUE_SUBMISSION;
+            } else if (std::strcmp(mode, "batch") == 0) {
+                options.m_submission = BATCH_SUBMISSION;
+            } else if (std::strcmp(mode, "indirect") == 0) {
+                options.m_submission = INDIRECT_SUBMISSION;
+            } else {
+                return false;
+            }
+        } else if ((std::strcmp(argument, "--particles") == 0) && has_value) {
+            options.m_particles = std::atoi(argv[++i]);
+        } else if ((std::strcmp(argument, "--output") == 0) && has_value) {
+            options.m_output = argv[++i];
+        } else if ((std::strcmp(argument, "--trace") == 0) && has_value) {
+            options.m_trace = argv[++i];
         } else {
-            unit_pos.y += 1.0f/static_cast<float>(y_resolution - 1);
+            return false;
         }
     }
-    return unit_pos;
+    return (options.m_frames > 0) && (options.m_timestep > 0) && (options.m_tickRate > 0) && (options.m_frameRate >= 0) && (options.m_particles >= 0);
 }
 
-Object initalizeSurface(GLuint shaderID) {
-    constexpr int x_resolution = 100;
-    constexpr int y_resolution = 100;
-    constexpr int num_vertices = (x_resolution - 1)*(y_resolution - 1)*2*3; // (x_resolution - 1)*(y_resolution - 1) quads, 2 triangles per quad, 3 points per triangle
+/// Writes the frame time statistics of a headless run as JSON, the
+/// times are in milliseconds.
+/// @param startup Time in seconds from launch to the first frame.
+void writeBenchmark(const Options& options, const HistogramTimer& timer, double startup) {
+    std::ofstream file(options.m_output);
+    if (!file) {
+        std::cerr << "Failed to open " << options.m_output << " for writing.\n";
+        return;
+    }
+
+    // the renderer string is only escaped enough to keep the JSON valid
+    std::string renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    for (char& character : renderer) {
+        if ((character == '"') || (character == '\\')) {
+            character = '\'';
+        }
+    }
 
-    GLfloat g_vertex_buffer_data[num_vertices*3];
-    GLfloat g_color_buffer_data[num_vertices*3];
+    const FrameHistogram& histogram = timer.getHistogram();
+    file << "{\n"
+         << "  \"renderer\": \"" << renderer << "\",\n"
+         << "  \"frames\": " << histogram.count() << ",\n"
+         << "  \"timestep\": " << options.m_timestep << ",\n"
+         << "  \"tick_rate\": " << options.m_tickRate << ",\n"
+         << "  \"submission\": \"" << submissionName(options.m_submission) << "\",\n"
+         << "  \"particles\": " << options.m_particles << ",\n"
+         << "  \"startup_ms\": " << 1e3*startup << ",\n"
+         << "  \"program_cache_hits\": " << GetShaderCacheStats().m_hits << ",\n"
+         << "  \"frame_time_ms\": {\n"
+         << "    \"mean\": " << 1e3*histogram.mean() << ",\n"
+         << "    \"min\": " << 1e3*histogram.min() << ",\n"
+         << "    \"max\": " << 1e3*histogram.max() << ",\n"
+         << "    \"p50\": " << 1e3*histogram.percentile(50) << ",\n"
+         << "    \"p90\": " << 1e3*histogram.percentile(90) << ",\n"
+         << "    \"p99\": " << 1e3*histogram.percentile(99) << ",\n"
+         << "    \"p99.9\": " << 1e3*histogram.percentile(99.9) << "\n"
+         << "  },\n"
+         << "  \"over_budget\": " << timer.getOverBudgetCount() << "\n"
+         << "}\n";
+}
 
-    for (int vertex_index = 0; vertex_index < num_vertices; vertex_index++) {
-        glm::vec2 unit_pos = meshgrid(x_resolution, y_resolution, vertex_index);
+constexpr size_t lod_levels = 3;
+/// Screen size from which the most detailed level is used, every other
+/// level is used down to half the screen size of the previous one.
+constexpr float lod_screen_size = 0.2f;
+constexpr int lod_min_resolution = 8;
 
-        float x = 5*(unit_pos.x - 0.5f);
-        float y = 5*(unit_pos.y - 0.5f);
+/// @return Grid resolution of a level of detail, halved for every level.
+int lodResolution(int resolution, size_t level) {
+    return std::max(resolution >> level, lod_min_resolution);
+}
 
-        g_vertex_buffer_data[0 + 3*vertex_index] = x;
-        g_vertex_buffer_data[2 + 3*vertex_index] = y;
-        g_vertex_buffer_data[1 + 3*vertex_index] = std::exp(-(x*x + y*y));
+/// @return Smallest screen size a level of detail is used for.
+float lodScreenSize(size_t level) {
+    return (level + 1 < lod_levels) ? lod_screen_size/static_cast<float>(1 << level) : 0.f;
+}
 
-        g_color_buffer_data[0 + 3*vertex_index] = unit_pos.x;
-        g_color_buffer_data[1 + 3*vertex_index] = unit_pos.y;
-        g_color_buffer_data[2 + 3*vertex_index] = std::exp(-(x*x + y*y));
+/// Vertices and indices of the shared geometry pool, enough for every
+/// level of the sphere and torus.
+constexpr GLsizei pool_vertex_capacity = 1 << 16;
+constexpr GLsizei pool_index_capacity = 1 << 18;
+
+/// Uploads the mesh to the geometry pool, or to buffers of its own once
+/// the pool is full.
+Model initalizeModel(Arena& arena, GeometryPool& pool, const Mesh& mesh) {
+    Model model = Model();
+    if (!pool.add(mesh, model)) {
+        std::cerr << "Geometry pool is full, the mesh gets buffers of its own.\n";
+        model.setVertexBuffer<Mesh::Format>(mesh.m_vertices, mesh.m_vertexCount);
+        model.setIndexBuffer(mesh.m_indices, mesh.m_indexCount, mesh.m_indexType);
     }
 
-    Model model = Model(shaderID);
-    model.setVertexBuffer(g_vertex_buffer_data, sizeof(g_vertex_buffer_data));
-    model.setColorBuffer(g_color_buffer_data, sizeof(g_color_buffer_data));
-    Object surface = Object(model);
-    return surface;
+    // the mesh has been uploaded so the staging memory can be reused
+    arena.reset();
+    return model;
 }
 
-Object initalizeSphere(GLuint shaderID) {
-    constexpr int x_resolution = 32; // rows
-    constexpr int y_resolution = 16; // columns
-    constexpr int num_vertices = (x_resolution - 1)*(y_resolution - 1)*2*3; // (x_resolution - 1)*(y_resolution - 1) quads, 2 triangles per quad, 3 points per triangle
-
-    GLfloat g_vertex_buffer_data[num_vertices*3];
-    GLfloat g_color_buffer_data[num_vertices*3];
+/// Version of the generated meshes, part of every mesh cache key. Bump
+/// it whenever a generator or the grid construction changes, so caches
+/// written by older builds are rebuilt. Changes to the file layout are
+/// covered by `MeshCacheHeader::VERSION`.
+constexpr std::uint32_t MESH_CACHE_VERSION = 1;
+
+/// Maps the mesh from the cache if there is a valid one, otherwise builds
+/// it and writes the cache for the next launch. The cache key is made
+/// from the name, the resolution and `MESH_CACHE_VERSION`.
+template<typename Function>
+Model initalizeCachedGrid(Arena& arena, GeometryPool& pool, JobSystem& jobs, const std::string& name, int x_resolution, int y_resolution, Function function) {
+    std::string path = get_fixed_path("mesh_cache/" + name + ".mesh").string();
+    int resolution[2] = {x_resolution, y_resolution};
+    std::uint64_t key = fnv1a(&MESH_CACHE_VERSION, sizeof(MESH_CACHE_VERSION), fnv1a(name));
+    key = fnv1a(resolution, sizeof(resolution), key);
+
+    MappedMesh cached;
+    if (cached.open(path, key)) {
+        std::clog << "Loaded mesh cache : " << path << "\n";
+        return initalizeModel(arena, pool, cached.m_mesh);
+    }
 
-    for (int vertex_index = 0; vertex_index < num_vertices; vertex_index++) {
-        glm::vec2 unit_pos = meshgrid(x_resolution, y_resolution, vertex_index);
+    Mesh mesh = buildParametricMesh(arena, x_resolution, y_resolution, function, jobs);
+    if (writeMeshCache(path, mesh, key)) {
+        std::clog << "Wrote mesh cache : " << path << "\n";
+    }
+    return initalizeModel(arena, pool, mesh);
+}
 
-        float theta = 6.28f*unit_pos.x;
-        float phi = 3.14f*unit_pos.y;
+/// Builds a chain of levels of detail from a parametric function, each
+/// level evaluated on a grid of half the resolution of the previous one
+/// and cached separately.
+template<typename Function>
+LodChain initalizeCachedLods(Arena& arena, GeometryPool& pool, ModelRegistry& models, JobSystem& jobs, const std::string& name, int x_resolution, int y_resolution, Function function) {
+    LodChain chain;
+    for (size_t level = 0; level < lod_levels; level++) {
+        Model model = initalizeCachedGrid(arena, pool, jobs, name + "_lod" + std::to_string(level),
+                                          lodResolution(x_resolution, level), lodResolution(y_resolution, level), function);
+        chain.addLevel(models.add(std::move(model)), lodScreenSize(level));
+    }
+    return chain;
+}
 
-        float x = std::sin(phi)*std::cos(theta);
-        float y = std::sin(phi)*std::sin(theta);
-        float z = std::cos(phi);
+constexpr int surface_x_resolution = 100;
+constexpr int surface_y_resolution = 100;
+
+/// A gaussian surface with a height that oscillates in time.
+void surfaceFunction(Float4 u, Float4 v, float time, Float4 position[3], Float4 color[3]) {
+    Float4 x = 5.f*(u - 0.5f);
+    Float4 y = 5.f*(v - 0.5f);
+    Float4 height = simdExp(-(x*x + y*y));
+
+    position[0] = x;
+    position[1] = height*std::cos(time);
+    position[2] = y;
+    color[0] = u;
+    color[1] = v;
+    color[2] = height;
+}
 
-        g_vertex_buffer_data[0 + 3*vertex_index] = x;
-        g_vertex_buffer_data[2 + 3*vertex_index] = y;
-        g_vertex_buffer_data[1 + 3*vertex_index] = z;
+/// Writes the surface at the given time to the next region of the
+/// stream buffer and points the surface's model at it. The surface is
+/// evaluated at the resolution of its current level of detail.
+void animateSurface(Object& surface, ModelRegistry& models, StreamBuffer& stream, float time, JobSystem& jobs) {
+    int x_resolution = lodResolution(surface_x_resolution, surface.m_lod);
+    int y_resolution = lodResolution(surface_y_resolution, surface.m_lod);
+    GLfloat* vertices = static_cast<GLfloat*>(stream.beginWrite());
+    evaluateParametricGrid(x_resolution, y_resolution, [time](Float4 u, Float4 v, Float4 position[3], Float4 color[3]) {
+        surfaceFunction(u, v, time, position, color);
+    }, vertices, jobs);
+    stream.endWrite();
+
+    models.get(surface.m_model)->setVertexStream<Mesh::Format>(stream);
+}
 
-        g_color_buffer_data[0 + 3*vertex_index] = unit_pos.x;
-        g_color_buffer_data[1 + 3*vertex_index] = unit_pos.y;
-        g_color_buffer_data[2 + 3*vertex_index] = 0.0f;
+LodChain initalizeSurface(Arena& arena, ModelRegistry& models, StreamBuffer& stream) {
+    // the height stays within [-1, 1] as the surface animates
+    BoundingBox box;
+    box.m_min = glm::vec3(-2.5f, -1.f, -2.5f);
+    box.m_max = glm::vec3(2.5f, 1.f, 2.5f);
+
+    // the vertices are animated so only the indices are static, the
+    // vertices of every level come from the stream buffer
+    LodChain chain;
+    for (size_t level = 0; level < lod_levels; level++) {
+        Mesh mesh;
+        buildGridIndices(arena, mesh, lodResolution(surface_x_resolution, level), lodResolution(surface_y_resolution, level));
+
+        Model model = Model();
+        model.setIndexBuffer(mesh.m_indices, mesh.m_indexCount, mesh.m_indexType);
+        model.setBounds(box);
+        // set up the vertex array once so switching levels does not
+        // create a new one
+        model.setVertexStream<Mesh::Format>(stream);
+        chain.addLevel(models.add(std::move(model)), lodScreenSize(level));
+        arena.reset();
     }
+    return chain;
+}
 
-    Model model = Model(shaderID);
-    model.setVertexBuffer(g_vertex_buffer_data, sizeof(g_vertex_buffer_data));
-    model.setColorBuffer(g_color_buffer_data, sizeof(g_color_buffer_data));
-    Object sphere = Object(model);
-    return sphere;
+LodChain initalizeSphere(Arena& arena, GeometryPool& pool, ModelRegistry& models, JobSystem& jobs) {
+    constexpr int x_resolution = 32; // rows
+    constexpr int y_resolution = 16; // columns
+
+    return initalizeCachedLods(arena, pool, models, jobs, "sphere", x_resolution, y_resolution, [](Float4 u, Float4 v, Float4 position[3], Float4 color[3]) {
+        Float4 sin_theta, cos_theta, sin_phi, cos_phi;
+        simdSinCos(6.28f*u, sin_theta, cos_theta);
+        simdSinCos(3.14f*v, sin_phi, cos_phi);
+
+        position[0] = sin_phi*cos_theta;
+        position[1] = cos_phi;
+        position[2] = sin_phi*sin_theta;
+        color[0] = u;
+        color[1] = v;
+        color[2] = 0.0f;
+    });
 }
 
-Object initalizeTorus(GLuint shaderID) {
+LodChain initalizeTorus(Arena& arena, GeometryPool& pool, ModelRegistry& models, JobSystem& jobs) {
     constexpr int x_resolution = 100; // rows
     constexpr int y_resolution = 100; // columns
-    constexpr int num_vertices = (x_resolution - 1)*(y_resolution - 1)*2*3; // (x_resolution - 1)*(y_resolution - 1) quads, 2 triangles per quad, 3 points per triangle
-
-    GLfloat g_vertex_buffer_data[num_vertices*3];
-    GLfloat g_color_buffer_data[num_vertices*3];
-
-    for (int vertex_index = 0; vertex_index < num_vertices; vertex_index++) {
-        glm::vec2 unit_pos = meshgrid(x_resolution, y_resolution, vertex_index);
-
-        float theta = 6.28f*unit_pos.x;
-        float phi = 6.28f*unit_pos.y;
 
-        float x = (1.0f + 0.5f*std::cos(theta))*std::cos(phi);
-        float y = (1.0f + 0.5f*std::cos(theta))*std::sin(phi);
-        float z = 0.5f*std::sin(theta);
-
-        g_vertex_buffer_data[0 + 3*vertex_index] = x;
-        g_vertex_buffer_data[2 + 3*vertex_index] = y;
-        g_vertex_buffer_data[1 + 3*vertex_index] = z;
+    return initalizeCachedLods(arena, pool, models, jobs, "torus", x_resolution, y_resolution, [](Float4 u, Float4 v, Float4 position[3], Float4 color[3]) {
+        Float4 sin_theta, cos_theta, sin_phi, cos_phi;
+        simdSinCos(6.28f*u, sin_theta, cos_theta);
+        simdSinCos(6.28f*v, sin_phi, cos_phi);
+
+        Float4 radius = 1.0f + 0.5f*cos_theta;
+        position[0] = radius*cos_phi;
+        position[1] = 0.5f*sin_theta;
+        position[2] = radius*sin_phi;
+        color[0] = u;
+        color[1] = v;
+        color[2] = 0.0f;
+    });
+}
 
-        g_color_buffer_data[0 + 3*vertex_index] = unit_pos.x;
-        g_color_buffer_data[1 + 3*vertex_index] = unit_pos.y;
-        g_color_buffer_data[2 + 3*vertex_index] = 0.0f;
+/// Spacing of the particles on the grid they start on.
+constexpr float particle_spacing = 3.f;
+
+/// Places the particles on a square grid around the scene, each thrown
+/// upwards with a different speed so they bounce out of step.
+void initalizeParticles(PhysicsWorld& world, int count) {
+    int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count))));
+    float offset = 0.5f*particle_spacing*static_cast<float>(side - 1);
+    for (int i = 0; i < count; i++) {
+        glm::vec3 position = glm::vec3(particle_spacing*static_cast<float>(i % side) - offset, 1.f,
+                                       particle_spacing*static_cast<float>(i / side) - offset - 1.5f);
+        glm::vec3 velocity = glm::vec3(0.f, 5.f + 5.f*std::sin(static_cast<float>(i)), 0.f);
+        world.addBody(position, velocity, glm::vec3(0.0f, -9.81f, 0.0f));
     }
+}
 
-    Model model = Model(shaderID);
-    model.setVertexBuffer(g_vertex_buffer_data, sizeof(g_vertex_buffer_data));
-    model.setColorBuffer(g_color_buffer_data, sizeof(g_color_buffer_data));
-    Object torus = Object(model);
-    return torus;
+/// @return Path of a shader. In a build tree this is the original in the
+/// source tree, so `ShaderManager` reloads it when it is edited, and
+/// otherwise the copy staged next to the executable.
+std::string shaderPath(const std::string& name) {
+#ifdef __PROJECT___ASSETS_SOURCE_DIR
+    std::filesystem::path source = std::filesystem::path(__PROJECT___ASSETS_SOURCE_DIR) / name;
+    if (std::filesystem::exists(source)) {
+        return source.string();
+    }
+#endif
+    return std::string(__PROJECT___ASSETS_SUBDIR) + "/" + name;
 }
 
-int main() {
-    LoopLog* loopLog = LoopLog::getInstance();
-    if (!glfwInit()) {
-        std::cerr << "Failed to initalize GLFW\n";
+int main(int argc, char* argv[]) {
+    std::chrono::steady_clock::time_point launch = std::chrono::steady_clock::now();
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
         return -1;
     }
+    if (!options.m_trace.empty()) {
+        PROFILE_ENABLE_TRACE();
+    }
 
-    GLFWwindow* window;
+    LoopLog* loopLog = LoopLog::getInstance();
+    RenderStats* renderStats = RenderStats::getInstance();
     int width=1024, height=768;
-    window = glfwCreateWindow( width, height, "GLTest", NULL, NULL);
-    if (window == NULL) {
-        std::cerr << "Failed to create GLFW window.\n";
-        glfwTerminate();
-        return -1;
+    GLFWwindow* window = NULL;
+    HeadlessContext headless = HeadlessContext();
+
+    if (options.m_headless) {
+        if (!headless.create(width, height)) {
+            return -1;
+        }
+    } else {
+        if (!glfwInit()) {
+            std::cerr << "Failed to initalize GLFW\n";
+            return -1;
+        }
+
+        window = glfwCreateWindow( width, height, "GLTest", NULL, NULL);
+        if (window == NULL) {
+            std::cerr << "Failed to create GLFW window.\n";
+            glfwTerminate();
+            return -1;
+        }
+
+        glfwMakeContextCurrent(window);
+        glfwSwapInterval(0);
     }
 
-    glfwMakeContextCurrent(window);
-    glfwSwapInterval(0);
-    if (glewInit() != GLEW_OK) {
+    // load every function the driver has, GLEW's extension checks miss
+    // the extensions of core profile contexts such as the headless one
+    glewExperimental = GL_TRUE;
+    GLenum glewStatus = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // GLEW built for GLX finds no X display when the context comes from
+    // EGL, the core OpenGL functions are loaded regardless
+    if (options.m_headless && (glewStatus == GLEW_ERROR_NO_GLX_DISPLAY)) {
+        glewStatus = GLEW_OK;
+    }
+#endif
+    if (glewStatus != GLEW_OK) {
         std::cerr << "Failed to initalize GLEW.\n";
         return -1;
     }
 
+    if (options.m_headless && !headless.createFramebuffer()) {
+        headless.release();
+        return -1;
+    }
+
     glClearColor(.6f, .65f, .7f, 1.f);
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);
 
-    glfwSetInputMode(window, GLFW_STICKY_KEYS, GL_TRUE);
-    //glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-
-    GLuint VertexArrayID;
-    glGenVertexArrays(1, &VertexArrayID);
-    glBindVertexArray(VertexArrayID);
+    if (!options.m_headless) {
+        glfwSetInputMode(window, GLFW_STICKY_KEYS, GL_TRUE);
+        //glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    }
 
     // Initalize shader
-    GLuint shaderID = LoadShaders("assets/vertex.glsl", "assets/fragment.glsl");
-
-    AdvancedTimer timer = AdvancedTimer();
-    Camera camera = Camera(shaderID);
-    Object surface = initalizeSurface(shaderID);
-
-    Object sphere = initalizeSphere(shaderID);
+    ShaderManager shaders = ShaderManager();
+    ShaderManager::ProgramHandle program = shaders.load(shaderPath("vertex.glsl"), shaderPath("fragment.glsl"));
+    ShaderManager::ProgramHandle indirectProgram = program;
+    if (options.m_submission == INDIRECT_SUBMISSION) {
+        if (IndirectRenderer::isSupported()) {
+            indirectProgram = shaders.load(shaderPath("indirect_vertex.glsl"), shaderPath("fragment.glsl"));
+        } else {
+            std::cerr << "Multi draw indirect is not supported, using the render queue instead.\n";
+            options.m_submission = QUEUE_SUBMISSION;
+        }
+    }
+    shaders.wait();
+    if (shaders.getProgram(program) == 0) {
+        return -1;
+    }
+    if ((options.m_submission == INDIRECT_SUBMISSION) && (shaders.getProgram(indirectProgram) == 0)) {
+        std::cerr << "Using the render queue instead of multi draw indirect.\n";
+        options.m_submission = QUEUE_SUBMISSION;
+    }
+    // the particles are integrated and drawn straight from GPU buffers
+    std::unique_ptr<ComputeIntegrator> particles;
+    if (options.m_particles > 0) {
+        if (ComputeIntegrator::isSupported()) {
+            particles.reset(new ComputeIntegrator());
+            if (!particles->load(shaderPath("integrate_compute.glsl"))) {
+                particles->releaseBuffers();
+                particles.reset();
+            }
+        } else {
+            std::cerr << "Compute shaders are not supported, the particles are disabled.\n";
+        }
+        if (!particles) {
+            options.m_particles = 0;
+        }
+    }
+    ShaderCacheStats shaderCache = GetShaderCacheStats();
+    std::clog << "Program cache [hits | misses]: [" << shaderCache.m_hits << " | " << shaderCache.m_misses << "]\n";
+
+    GpuTimer gpuTimer = GpuTimer();
+    JobSystem jobs = JobSystem();
+    UniformBuffers uniforms = UniformBuffers();
+    Camera camera = Camera();
+    BatchRenderer renderer = BatchRenderer();
+    RenderQueue queue = RenderQueue();
+    std::unique_ptr<IndirectRenderer> indirect;
+    if (options.m_submission == INDIRECT_SUBMISSION) {
+        indirect.reset(new IndirectRenderer());
+    }
+    // staging memory for the geometry, released once it is on the GPU
+    Arena arena = Arena();
+    // every model lives here, objects and LOD chains refer to them by handle
+    ModelRegistry models = ModelRegistry();
+    StreamBuffer surfaceStream = StreamBuffer(GL_ARRAY_BUFFER, Mesh::Format::stride*surface_x_resolution*surface_y_resolution);
+    LodChain surfaceLods = initalizeSurface(arena, models, surfaceStream);
+    Object surface = Object(&surfaceLods);
+
+    // the static meshes share one set of buffers, the surface is streamed
+    GeometryPool pool = GeometryPool(pool_vertex_capacity, pool_index_capacity);
+    LodChain sphereLods = initalizeSphere(arena, pool, models, jobs);
+    Object sphere = Object(&sphereLods);
     sphere.m_position = glm::vec3(3.0f, 0.0f, -3.0f);
     sphere.m_velocity = glm::vec3(0.0f, 10.0f, 0.0f);
     sphere.m_acceleration = glm::vec3(0.0f, -9.81f, 0.0f);
 
-    Object torus = initalizeTorus(shaderID);
+    LodChain torusLods = initalizeTorus(arena, pool, models, jobs);
+    Object torus = Object(&torusLods);
     torus.m_position = glm::vec3(-3.0f, 0.0f, -3.0f);
+    arena.release();
+
+    if (particles) {
+        PhysicsWorld world = PhysicsWorld();
+        initalizeParticles(world, options.m_particles);
+        if (!particles->upload(world)) {
+            particles->releaseBuffers();
+            particles.reset();
+            options.m_particles = 0;
+        }
+    }
+
+    double startup = std::chrono::duration<double>(std::chrono::steady_clock::now() - launch).count();
+    std::clog << "Startup took " << 1e3*startup << " ms\n";
+
+    Object* objects[] = {&surface, &sphere, &torus};
+    constexpr size_t num_objects = sizeof(objects)/sizeof(objects[0]);
+    BoundingVolumeHierarchy bvh = BoundingVolumeHierarchy();
+    std::vector<Bounds> worldBounds(num_objects);
+    const size_t object_chunk = std::max<size_t>(1, (num_objects + jobs.threadCount())/(jobs.threadCount() + 1));
+    std::vector<std::uint32_t> visible;
+
+    // nothing has moved yet, so there is nothing to interpolate from
+    for (Object* object : objects) {
+        object->m_previousPosition = object->m_position;
+    }
+    FixedStepScheduler scheduler = FixedStepScheduler(options.m_tickRate);
+
+    // the swap interval is 0 so without pacing the loop runs as fast as
+    // it can, headless runs measure exactly that
+    bool paced = !options.m_headless && (options.m_frameRate > 0);
+    FramePacer pacer = FramePacer(paced ? options.m_frameRate : 60.0);
+
+    // started after the setup so the first frame does not include it
+    HistogramTimer timer = HistogramTimer();
     float dt;
+    int frame = 0;
+    bool running = true;
     do {
-        // Timing
-        dt = static_cast<float>(timer.timer());
+        PROFILE_SCOPE("Frame");
+        if (paced) {
+            PROFILE_SCOPE("FramePacer::beginFrame");
+            pacer.beginFrame();
+        }
+        // Timing, headless runs use a fixed time step so every run
+        // simulates and renders exactly the same frames
+        float time;
+        if (options.m_headless) {
+            dt = options.m_timestep;
+            time = static_cast<float>(frame)*options.m_timestep;
+        } else {
+            dt = static_cast<float>(timer.timer());
+            time = static_cast<float>(timer.getTime());
+        }
+        PROFILE_END_FRAME();
         loopLog->flush();
+        gpuTimer.beginFrame();
 
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         //Camera
-        Controlls(dt, window, camera);
+        {
+            PROFILE_SCOPE("Controlls");
+            if (options.m_headless) {
+                scriptedCamera(time, camera);
+            } else {
+                Controlls(dt, window, camera);
+            }
+        }
+
+        {
+            PROFILE_SCOPE("ShaderManager::update");
+            shaders.update();
+        }
+
+        {
+            PROFILE_SCOPE("Camera::update");
+            camera.update(uniforms);
+        }
 
-        glUseProgram(shaderID);
-        camera.update();
+        {
+            PROFILE_SCOPE("Update");
+            // the simulation runs in fixed steps whatever the frame time,
+            // and the objects are drawn between their last two steps
+            unsigned int steps = scheduler.advance(dt);
+            float step = scheduler.getStep();
+            float alpha = scheduler.getAlpha();
+            // object updates do not touch OpenGL so they can run on the
+            // workers, one chunk for each worker and the calling thread
+            jobs.parallelFor(num_objects, object_chunk, [&](size_t begin, size_t end) {
+                PROFILE_SCOPE("Object::update");
+                for (size_t i = begin; i < end; i++) {
+                    for (unsigned int j = 0; j < steps; j++) {
+                        objects[i]->update(step);
+                    }
+                    objects[i]->interpolate(alpha);
+                }
+            });
+            if (particles) {
+                PROFILE_SCOPE("ComputeIntegrator::update");
+                particles->update(step, steps, alpha);
+            }
+        }
 
-        surface.update(dt);
-        sphere.update(dt);
-        torus.update(dt);
+        {
+            PROFILE_SCOPE("Culling");
+            for (size_t i = 0; i < num_objects; i++) {
+                worldBounds[i] = objects[i]->getWorldBounds(models);
+            }
+            bvh.update(worldBounds);
+            bvh.cull(Frustum(camera.m_viewProjection), visible);
+            renderStats->m_visibleObjects += visible.size();
+            renderStats->m_culledObjects += num_objects - visible.size();
+        }
 
-        surface.drawObject();
-        sphere.drawObject();
-        torus.drawObject();
+        {
+            PROFILE_SCOPE("LOD selection");
+            for (std::uint32_t index : visible) {
+                objects[index]->selectLod(camera.projectedSize(worldBounds[index].m_sphere));
+            }
+        }
 
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    } while ((glfwGetKey(window, GLFW_KEY_ESCAPE) != GLFW_PRESS) && (glfwWindowShouldClose(window) == 0));
-    glfwDestroyWindow(window);
-    glfwTerminate();
+        {
+            PROFILE_SCOPE("animateSurface");
+            animateSurface(surface, models, surfaceStream, time, jobs);
+        }
+
+        {
+            PROFILE_SCOPE("Draw submission");
+            gpuTimer.beginPass("Draw");
+            // the program changes when its shaders are reloaded, the
+            // models of the objects live as long as their LOD chains
+            GLuint program_id = shaders.getProgram(program);
+            if (options.m_submission == QUEUE_SUBMISSION) {
+                for (std::uint32_t index : visible) {
+                    float depth = glm::distance(camera.m_position, worldBounds[index].m_sphere.m_center);
+                    queue.submit(program_id, *models.get(objects[index]->m_model), objects[index]->m_modelSpaceToWorldSpace, depth);
+                }
+                queue.draw(uniforms);
+            } else if (options.m_submission == INDIRECT_SUBMISSION) {
+                GLuint indirect_program_id = shaders.getProgram(indirectProgram);
+                for (std::uint32_t index : visible) {
+                    indirect->submit(indirect_program_id, *models.get(objects[index]->m_model), objects[index]->m_modelSpaceToWorldSpace);
+                }
+                indirect->draw();
+            } else {
+                glUseProgram(program_id);
+                for (std::uint32_t index : visible) {
+                    renderer.submit(objects[index]->m_model, *models.get(objects[index]->m_model), objects[index]->m_modelSpaceToWorldSpace);
+                }
+                renderer.draw(uniforms);
+            }
+            if (particles) {
+                // the particles use the least detailed sphere
+                glUseProgram(program_id);
+                particles->draw(*models.get(sphereLods.getLevel(lod_levels - 1)), uniforms);
+            }
+            surfaceStream.lockRegion();
+            uniforms.lockRegions();
+            gpuTimer.endPass();
+        }
+        gpuTimer.endFrame();
+        renderStats->endFrame(timer.getTime());
+
+        if (options.m_headless) {
+            // wait for the frame to finish so its time includes rendering
+            {
+                PROFILE_SCOPE("glFinish");
+                glFinish();
+            }
+            timer.timer();
+            running = (++frame < options.m_frames);
+        } else {
+            {
+                PROFILE_SCOPE("glfwSwapBuffers");
+                glfwSwapBuffers(window);
+            }
+            glfwPollEvents();
+            if (paced) {
+                pacer.endFrame();
+            }
+            running = (glfwGetKey(window, GLFW_KEY_ESCAPE) != GLFW_PRESS) && (glfwWindowShouldClose(window) == 0);
+        }
+    } while (running);
+    loopLog->close();
+    if (options.m_headless) {
+        writeBenchmark(options, timer, startup);
+    }
+    timer.exportHistogram("frame_times.csv");
+    if (!options.m_trace.empty()) {
+        PROFILE_WRITE_TRACE(options.m_trace);
+    }
+    gpuTimer.releaseQueries();
+    shaders.releasePrograms();
+    renderer.releaseBuffers();
+    if (indirect) {
+        indirect->releaseBuffers();
+    }
+    if (particles) {
+        particles->releaseBuffers();
+    }
+    uniforms.releaseBuffers();
+    surfaceStream.releaseBuffers();
+    // the GL objects have to be deleted before the context is destroyed
+    models.clear();
+    pool.releaseBuffers();
+    if (options.m_headless) {
+        headless.release();
+    } else {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+    }
     return 0;
 }
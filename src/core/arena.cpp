@@ -0,0 +1,56 @@
+#include "core/arena.h"
+
+#include <cstdint>
+
+Arena::Arena(size_t blockSize) : m_blockSize(blockSize), m_currentBlock(0), m_offset(0) {
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+    // search the remaining blocks for one with enough space, blocks left
+    // over from before the last reset are reused before allocating more
+    while (m_currentBlock < m_blocks.size()) {
+        Block& block = m_blocks[m_currentBlock];
+        std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.m_data.get());
+        std::uintptr_t aligned = (base + m_offset + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+        size_t offset = static_cast<size_t>(aligned - base);
+        if (offset + size <= block.m_size) {
+            m_offset = offset + size;
+            return block.m_data.get() + offset;
+        }
+        m_currentBlock++;
+        m_offset = 0;
+    }
+
+    // oversized requests get a block of their own
+    size_t block_size = (size + alignment > m_blockSize) ? size + alignment : m_blockSize;
+    m_blocks.push_back(Block{std::unique_ptr<unsigned char[]>(new unsigned char[block_size]), block_size});
+    m_currentBlock = m_blocks.size() - 1;
+    m_offset = 0;
+    return allocate(size, alignment);
+}
+
+void Arena::reset() {
+    m_currentBlock = 0;
+    m_offset = 0;
+}
+
+void Arena::release() {
+    m_blocks.clear();
+    reset();
+}
+
+size_t Arena::bytesUsed() const {
+    size_t used = m_offset;
+    for (size_t i = 0; i < m_currentBlock && i < m_blocks.size(); i++) {
+        used += m_blocks[i].m_size;
+    }
+    return used;
+}
+
+size_t Arena::bytesReserved() const {
+    size_t reserved = 0;
+    for (const Block& block : m_blocks) {
+        reserved += block.m_size;
+    }
+    return reserved;
+}
@@ -0,0 +1,58 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/// A bump allocator for transient data such as geometry that is staged
+/// on the CPU before it is uploaded to the GPU. Allocations are carved
+/// out of large blocks and are never freed individually, instead
+/// `reset()` releases everything at once while keeping the blocks for
+/// reuse. Only trivially destructible types should be allocated since
+/// destructors are never run.
+class Arena {
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> m_data;
+        size_t m_size;
+    };
+
+    std::vector<Block> m_blocks;
+    size_t m_blockSize;
+    size_t m_currentBlock;
+    size_t m_offset;
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+public:
+    /// @param blockSize Minimum size in bytes of each block requested
+    /// from the system.
+    explicit Arena(size_t blockSize = 16*1024*1024);
+
+    /// Allocates uninitialized memory from the arena.
+    /// @param size Number of bytes to allocate.
+    /// @param alignment Alignment of the allocation, must be a power of two.
+    /// @return Pointer to the memory which stays valid until `reset()`.
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /// Allocates an uninitialized array of `count` elements of type `T`.
+    template<typename T>
+    T* allocate(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena does not run destructors");
+        return static_cast<T*>(allocate(count*sizeof(T), alignof(T)));
+    }
+
+    /// Invalidates all allocations but keeps the memory for reuse.
+    void reset();
+    /// Invalidates all allocations and returns the memory to the system.
+    void release();
+
+    /// @return Number of bytes handed out since the last reset.
+    size_t bytesUsed() const;
+    /// @return Number of bytes held by the arena.
+    size_t bytesReserved() const;
+};
+
+#endif
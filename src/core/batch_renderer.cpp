@@ -0,0 +1,127 @@
+#include "core/batch_renderer.h"
+
+#include <utility>
+
+#include "core/render_stats.h"
+
+BatchRenderer::BatchRenderer() {
+    m_instanceBufferSize = 0;
+    m_baseInstance = GLEW_ARB_base_instance;
+    m_instancebuffer = GLBuffer::create();
+}
+
+void BatchRenderer::releaseBuffers() {
+    m_batches.clear();
+    m_batchIndex.clear();
+    m_instancebuffer.reset();
+}
+
+/// The handle's generation is part of the key, so a model added in the
+/// slot of a removed one never reuses the removed model's batch.
+void BatchRenderer::submit(ModelHandle handle, const Model& model, const glm::mat4& modelSpaceToWorldSpace) {
+    std::uint64_t key = (static_cast<std::uint64_t>(handle.m_index) << 32) | handle.m_generation;
+    auto it = m_batchIndex.find(key);
+    if (it == m_batchIndex.end()) {
+        it = m_batchIndex.emplace(key, m_batches.size()).first;
+        m_batches.emplace_back();
+        m_batches.back().m_key = key;
+    }
+    // keep the latest model, the registry may have moved it since the
+    // last frame
+    Batch& batch = m_batches[it->second];
+    batch.m_model = &model;
+    batch.m_transforms.push_back(modelSpaceToWorldSpace);
+}
+
+void BatchRenderer::draw(UniformBuffers& uniforms) {
+    // a batch without instances may belong to a model that has been
+    // removed, so it is dropped and recreated if the model comes back
+    for (size_t i = 0; i < m_batches.size(); ) {
+        if (!m_batches[i].m_transforms.empty()) {
+            i++;
+            continue;
+        }
+        m_batchIndex.erase(m_batches[i].m_key);
+        if (i + 1 < m_batches.size()) {
+            m_batches[i] = std::move(m_batches.back());
+            m_batchIndex[m_batches[i].m_key] = i;
+        }
+        m_batches.pop_back();
+    }
+
+    size_t num_instances = 0;
+    for (const Batch& batch : m_batches) {
+        num_instances += batch.m_transforms.size();
+    }
+    if (num_instances == 0) {
+        return;
+    }
+
+    // orphan the previous frame's instance data so the driver does not
+    // have to wait for pending draws, growing the buffer if needed
+    GLsizeiptr required_size = static_cast<GLsizeiptr>(num_instances*sizeof(glm::mat4));
+    if (required_size > m_instanceBufferSize) {
+        m_instanceBufferSize = required_size;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, m_instancebuffer.get());
+    glBufferData(GL_ARRAY_BUFFER, m_instanceBufferSize, NULL, GL_STREAM_DRAW);
+
+    GLintptr offset = 0;
+    for (const Batch& batch : m_batches) {
+        GLsizeiptr size = static_cast<GLsizeiptr>(batch.m_transforms.size()*sizeof(glm::mat4));
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, batch.m_transforms.data());
+        offset += size;
+    }
+
+    RenderStats* stats = RenderStats::getInstance();
+    DrawBlock instanced = DrawBlock();
+    instanced.m_modelSpaceToWorldSpace = glm::mat4(1.f);
+    instanced.m_instanced = GL_TRUE;
+    size_t index = uniforms.addDraw(instanced);
+    uniforms.flush();
+    uniforms.bindDraw(index);
+
+    offset = 0;
+    for (Batch& batch : m_batches) {
+        GLsizei instance_count = static_cast<GLsizei>(batch.m_transforms.size());
+        const Model& model = *batch.m_model;
+        if (!batch.m_vertexArray) {
+            batch.m_vertexArray = GLVertexArray::create();
+        }
+        glBindVertexArray(batch.m_vertexArray.get());
+        stats->m_bindCalls++;
+        // like `Model::setVertexStream()` the vertex array is only set up
+        // again when the model moved to other buffers
+        if ((model.m_vertexbuffer != batch.m_vertexbuffer) || (model.m_indexbuffer != batch.m_indexbuffer)) {
+            glBindBuffer(GL_ARRAY_BUFFER, model.m_vertexbuffer);
+            model.m_setAttributes();
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model.m_indexbuffer);
+            batch.m_vertexbuffer = model.m_vertexbuffer;
+            batch.m_indexbuffer = model.m_indexbuffer;
+            stats->m_bindCalls++;
+        }
+
+        // the instance attributes only need to be set up again when the
+        // batch moved within the instance buffer. With base instances
+        // they always point at the start of the buffer and are set up once.
+        GLintptr attribute_offset = m_baseInstance ? 0 : offset;
+        GLuint base_instance = m_baseInstance ? static_cast<GLuint>(static_cast<size_t>(offset)/sizeof(glm::mat4)) : 0;
+        if (batch.m_instanceOffset != attribute_offset) {
+            glBindBuffer(GL_ARRAY_BUFFER, m_instancebuffer.get());
+            for (GLuint column = 0; column < 4; column++) {
+                glEnableVertexAttribArray(INSTANCE_ATTRIBUTE + column);
+                glVertexAttribDivisor(INSTANCE_ATTRIBUTE + column, 1);
+                glVertexAttribPointer(INSTANCE_ATTRIBUTE + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                                      (void*)(attribute_offset + static_cast<GLintptr>(column*sizeof(glm::vec4))));
+            }
+            stats->m_bindCalls++;
+            stats->m_attributeCalls += 12;
+            batch.m_instanceOffset = attribute_offset;
+        }
+        model.drawModelInstanced(instance_count, base_instance);
+
+        offset += static_cast<GLintptr>(batch.m_transforms.size()*sizeof(glm::mat4));
+        batch.m_transforms.clear();
+        batch.m_model = nullptr;
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef BATCH_RENDERER_H
+#define BATCH_RENDERER_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// keep this before all other OpenGL libraries
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "core/gl_object.h"
+#include "core/model.h"
+#include "core/uniform_buffers.h"
+
+/// A renderer that groups objects by their model and draws each group
+/// with a single instanced draw call. Objects are submitted every frame
+/// with `submit()` and `draw()` streams the model space to world space
+/// matrices of each group into a per-instance attribute buffer before
+/// issuing the draw calls.
+///
+/// Batches are identified by the handle of their model, so models that
+/// share buffers, such as the levels of a streamed model or the models
+/// of a `GeometryPool`, still get batches of their own. Each batch draws
+/// from a vertex array owned by the renderer, which reads the model's
+/// buffers and the instance buffer, so the models' own vertex arrays are
+/// left untouched. Batches that get no instances in a frame are dropped
+/// in `draw()` along with their vertex array, so batches of removed
+/// models do not pile up.
+class BatchRenderer {
+private:
+    struct Batch {
+        /// Key of the batch in `m_batchIndex`.
+        std::uint64_t m_key = 0;
+        /// Owned by the caller, the model submitted for the batch this
+        /// frame.
+        const Model* m_model = nullptr;
+        std::vector<glm::mat4> m_transforms;
+        GLVertexArray m_vertexArray;
+        /// Buffers of the model the vertex array was set up for.
+        GLuint m_vertexbuffer = 0;
+        GLuint m_indexbuffer = 0;
+        /// Offset in the instance buffer the instance attributes were
+        /// last set up for, -1 if they are not set up.
+        GLintptr m_instanceOffset = -1;
+    };
+
+    std::vector<Batch> m_batches;
+    std::unordered_map<std::uint64_t, size_t> m_batchIndex;
+    GLBuffer m_instancebuffer;
+    GLsizeiptr m_instanceBufferSize;
+    /// True if batches select their instances with a base instance
+    /// instead of moving the instance attributes, needs `ARB_base_instance`.
+    bool m_baseInstance;
+public:
+    /// Location of the first column of the per-instance matrix in the
+    /// vertex shader, the matrix uses this and the next three locations.
+    static constexpr GLuint INSTANCE_ATTRIBUTE = 2;
+
+    BatchRenderer();
+    void releaseBuffers();
+    /// Adds an instance of a model to the current frame.
+    /// @param handle Handle of the model, identifies its batch.
+    /// @param model Model to draw, owned by the caller and read in `draw()`.
+    void submit(ModelHandle handle, const Model& model, const glm::mat4& modelSpaceToWorldSpace);
+    /// Draws all objects submitted since the last call to `draw()`. The
+    /// batches share one draw block that selects the instance transforms.
+    /// Batches without objects are dropped, since their model may no
+    /// longer exist.
+    void draw(UniformBuffers& uniforms);
+};
+
+#endif
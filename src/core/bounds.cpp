@@ -0,0 +1,84 @@
+#include "core/bounds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+glm::vec3 BoundingBox::center() const {
+    return 0.5f*(m_min + m_max);
+}
+
+glm::vec3 BoundingBox::extent() const {
+    return 0.5f*(m_max - m_min);
+}
+
+float BoundingBox::surfaceArea() const {
+    glm::vec3 size = m_max - m_min;
+    return 2.f*(size.x*size.y + size.y*size.z + size.z*size.x);
+}
+
+void BoundingBox::merge(const BoundingBox& box) {
+    m_min = glm::min(m_min, box.m_min);
+    m_max = glm::max(m_max, box.m_max);
+}
+
+/// The box is found in one pass, the sphere is centered on the box and
+/// its radius found in a second pass, which is tighter than the sphere
+/// around the box for round models.
+Bounds computeBounds(const void* vertices, size_t vertexCount, size_t stride) {
+    Bounds bounds;
+    if (vertexCount == 0) {
+        return bounds;
+    }
+
+    const unsigned char* bytes = static_cast<const unsigned char*>(vertices);
+    glm::vec3 position;
+    std::memcpy(&position[0], bytes, sizeof(float)*3);
+    bounds.m_box.m_min = bounds.m_box.m_max = position;
+    for (size_t i = 1; i < vertexCount; i++) {
+        std::memcpy(&position[0], bytes + i*stride, sizeof(float)*3);
+        bounds.m_box.m_min = glm::min(bounds.m_box.m_min, position);
+        bounds.m_box.m_max = glm::max(bounds.m_box.m_max, position);
+    }
+
+    bounds.m_sphere.m_center = bounds.m_box.center();
+    float radius_squared = 0.f;
+    for (size_t i = 0; i < vertexCount; i++) {
+        std::memcpy(&position[0], bytes + i*stride, sizeof(float)*3);
+        glm::vec3 offset = position - bounds.m_sphere.m_center;
+        radius_squared = std::max(radius_squared, glm::dot(offset, offset));
+    }
+    bounds.m_sphere.m_radius = std::sqrt(radius_squared);
+    return bounds;
+}
+
+Bounds boundsFromBox(const BoundingBox& box) {
+    Bounds bounds;
+    bounds.m_box = box;
+    bounds.m_sphere.m_center = box.center();
+    bounds.m_sphere.m_radius = glm::length(box.extent());
+    return bounds;
+}
+
+/// Uses the absolute value of the transform to find the extent of the
+/// transformed box from its center and extent. The sphere radius is
+/// scaled by the largest scale of the transform.
+Bounds transformBounds(const Bounds& bounds, const glm::mat4& transform) {
+    glm::mat3 linear = glm::mat3(transform);
+    glm::vec3 translation = glm::vec3(transform[3]);
+    glm::mat3 absolute;
+    for (int i = 0; i < 3; i++) {
+        absolute[i] = glm::abs(linear[i]);
+    }
+
+    Bounds result;
+    glm::vec3 center = linear*bounds.m_box.center() + translation;
+    glm::vec3 extent = absolute*bounds.m_box.extent();
+    result.m_box.m_min = center - extent;
+    result.m_box.m_max = center + extent;
+
+    float scale = std::max(glm::length(linear[0]), std::max(glm::length(linear[1]), glm::length(linear[2])));
+    result.m_sphere.m_center = linear*bounds.m_sphere.m_center + translation;
+    result.m_sphere.m_radius = scale*bounds.m_sphere.m_radius;
+    return result;
+}
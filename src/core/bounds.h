@@ -0,0 +1,42 @@
+#ifndef BOUNDS_H
+#define BOUNDS_H
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+struct BoundingBox {
+    glm::vec3 m_min = glm::vec3(0.f);
+    glm::vec3 m_max = glm::vec3(0.f);
+
+    glm::vec3 center() const;
+    glm::vec3 extent() const;
+    float surfaceArea() const;
+    /// Grows the box to also contain `box`.
+    void merge(const BoundingBox& box);
+};
+
+struct BoundingSphere {
+    glm::vec3 m_center = glm::vec3(0.f);
+    float m_radius = 0.f;
+};
+
+/// The bounding volumes of a model or object. The sphere is a cheap
+/// conservative test and the box a tighter one.
+struct Bounds {
+    BoundingBox m_box;
+    BoundingSphere m_sphere;
+};
+
+/// Computes the bounds of a set of vertices.
+/// @param vertices Interleaved vertices with the position in the first
+/// three floats of each vertex.
+/// @param vertexCount Number of vertices.
+/// @param stride Size of a vertex in bytes.
+Bounds computeBounds(const void* vertices, size_t vertexCount, size_t stride);
+/// @return Bounds of a box with a sphere around it.
+Bounds boundsFromBox(const BoundingBox& box);
+/// Transforms bounds by an affine transform, the box is the smallest
+/// box containing the transformed box.
+Bounds transformBounds(const Bounds& bounds, const glm::mat4& transform);
+
+#endif
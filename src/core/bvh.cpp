@@ -0,0 +1,125 @@
+#include "core/bvh.h"
+
+#include <algorithm>
+
+void BoundingVolumeHierarchy::update(const std::vector<Bounds>& bounds) {
+    bool rebuild = (bounds.size() != m_bounds.size());
+    m_bounds = bounds;
+    if (rebuild) {
+        build();
+        return;
+    }
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    float surface_area = refit();
+    m_refits++;
+    if (surface_area > REBUILD_RATIO*m_builtSurfaceArea) {
+        build();
+    }
+}
+
+void BoundingVolumeHierarchy::build() {
+    m_nodes.clear();
+    m_indices.resize(m_bounds.size());
+    for (size_t i = 0; i < m_indices.size(); i++) {
+        m_indices[i] = static_cast<std::uint32_t>(i);
+    }
+    if (!m_indices.empty()) {
+        buildNode(0, static_cast<std::uint32_t>(m_indices.size()));
+    }
+    m_builtSurfaceArea = refit();
+    m_rebuilds++;
+}
+
+/// The node boxes are filled in by `refit()` afterwards, here only the
+/// box of the object centers is needed to choose the split axis.
+std::uint32_t BoundingVolumeHierarchy::buildNode(std::uint32_t first, std::uint32_t count) {
+    std::uint32_t index = static_cast<std::uint32_t>(m_nodes.size());
+    m_nodes.push_back(Node{BoundingBox(), 0, first, count});
+    if (count <= LEAF_SIZE) {
+        return index;
+    }
+
+    BoundingBox centers;
+    centers.m_min = centers.m_max = m_bounds[m_indices[first]].m_box.center();
+    for (std::uint32_t i = first + 1; i < first + count; i++) {
+        glm::vec3 center = m_bounds[m_indices[i]].m_box.center();
+        centers.m_min = glm::min(centers.m_min, center);
+        centers.m_max = glm::max(centers.m_max, center);
+    }
+    glm::vec3 size = centers.m_max - centers.m_min;
+    int axis = (size.x > size.y) ? ((size.x > size.z) ? 0 : 2) : ((size.y > size.z) ? 1 : 2);
+
+    std::uint32_t half = count/2;
+    std::vector<std::uint32_t>::iterator begin = m_indices.begin() + first;
+    std::nth_element(begin, begin + half, begin + count, [this, axis](std::uint32_t a, std::uint32_t b) {
+        return m_bounds[a].m_box.center()[axis] < m_bounds[b].m_box.center()[axis];
+    });
+
+    buildNode(first, half);
+    std::uint32_t right = buildNode(first + half, count - half);
+    m_nodes[index].m_right = right;
+    return index;
+}
+
+/// Children always come after their parent, so walking the nodes in
+/// reverse order visits both children before the parent.
+float BoundingVolumeHierarchy::refit() {
+    float surface_area = 0.f;
+    for (size_t i = m_nodes.size(); i-- > 0; ) {
+        Node& node = m_nodes[i];
+        if (node.m_right == 0) {
+            node.m_box = m_bounds[m_indices[node.m_first]].m_box;
+            for (std::uint32_t j = node.m_first + 1; j < node.m_first + node.m_count; j++) {
+                node.m_box.merge(m_bounds[m_indices[j]].m_box);
+            }
+        } else {
+            node.m_box = m_nodes[i + 1].m_box;
+            node.m_box.merge(m_nodes[node.m_right].m_box);
+        }
+        surface_area += node.m_box.surfaceArea();
+    }
+    return surface_area;
+}
+
+void BoundingVolumeHierarchy::cull(const Frustum& frustum, std::vector<std::uint32_t>& visible) {
+    visible.clear();
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    m_stack.clear();
+    m_stack.push_back(0);
+    while (!m_stack.empty()) {
+        std::uint32_t index = m_stack.back();
+        m_stack.pop_back();
+        const Node& node = m_nodes[index];
+
+        Frustum::Classification classification = frustum.classify(node.m_box);
+        if (classification == Frustum::OUTSIDE) {
+            continue;
+        }
+        std::vector<std::uint32_t>::const_iterator begin = m_indices.begin() + node.m_first;
+        if (classification == Frustum::INSIDE) {
+            visible.insert(visible.end(), begin, begin + node.m_count);
+        } else if (node.m_right == 0) {
+            // the sphere rejects most objects cheaply, the box catches
+            // the ones the sphere test is too loose for
+            for (std::vector<std::uint32_t>::const_iterator it = begin; it != begin + node.m_count; it++) {
+                const Bounds& bounds = m_bounds[*it];
+                if (frustum.intersects(bounds.m_sphere) && (frustum.classify(bounds.m_box) != Frustum::OUTSIDE)) {
+                    visible.push_back(*it);
+                }
+            }
+        } else {
+            m_stack.push_back(node.m_right);
+            m_stack.push_back(index + 1);
+        }
+    }
+}
+
+size_t BoundingVolumeHierarchy::size() const {
+    return m_bounds.size();
+}
@@ -0,0 +1,69 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "core/bounds.h"
+#include "core/frustum.h"
+
+/// A bounding volume hierarchy over the world space bounds of the objects
+/// in a scene, for culling them against the view frustum.
+///
+/// The tree is built once by splitting the objects at the median of the
+/// longest axis of their centers. As objects move `update()` refits the
+/// boxes of the existing tree bottom up, which is linear in the number of
+/// nodes. Refitting keeps the tree correct but lets it degrade, so the
+/// tree is rebuilt when the total surface area of its nodes has grown by
+/// `REBUILD_RATIO` since the last build, or when objects are added or
+/// removed.
+class BoundingVolumeHierarchy {
+public:
+    /// Largest number of objects in a leaf.
+    static constexpr std::uint32_t LEAF_SIZE = 4;
+    static constexpr float REBUILD_RATIO = 1.5f;
+private:
+    /// Nodes are stored in depth first order, so the left child of a node
+    /// directly follows it and every subtree covers a contiguous range of
+    /// `m_indices`.
+    struct Node {
+        BoundingBox m_box;
+        /// Index of the right child, 0 for leaves.
+        std::uint32_t m_right;
+        /// Range of `m_indices` covered by the subtree.
+        std::uint32_t m_first, m_count;
+    };
+
+    std::vector<Node> m_nodes;
+    /// Object indices ordered by the leaves containing them.
+    std::vector<std::uint32_t> m_indices;
+    std::vector<Bounds> m_bounds;
+    /// Total surface area of the nodes right after the last build.
+    float m_builtSurfaceArea = 0.f;
+    std::vector<std::uint32_t> m_stack;
+
+    void build();
+    /// Builds the subtree for a range of `m_indices`.
+    /// @return Index of the root of the subtree.
+    std::uint32_t buildNode(std::uint32_t first, std::uint32_t count);
+    /// Recomputes the boxes of all nodes from the object bounds.
+    /// @return Total surface area of the nodes.
+    float refit();
+public:
+    /// Number of rebuilds and refits since the hierarchy was created.
+    unsigned long m_rebuilds = 0, m_refits = 0;
+
+    /// Updates the hierarchy to the current bounds of the objects,
+    /// refitting or rebuilding it as needed.
+    /// @param bounds World space bounds of each object.
+    void update(const std::vector<Bounds>& bounds);
+    /// Finds the objects that are at least partially inside the frustum.
+    /// Subtrees completely inside the frustum are accepted without
+    /// testing their objects.
+    /// @param visible Replaced with the indices of the visible objects.
+    void cull(const Frustum& frustum, std::vector<std::uint32_t>& visible);
+    /// @return Number of objects in the hierarchy.
+    size_t size() const;
+};
+
+#endif
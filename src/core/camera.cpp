@@ -1,14 +1,16 @@
 #include "core/camera.h"
 
+#include <cmath>
+
 #include <glm/gtx/transform.hpp>
 
-Camera::Camera(GLuint shaderID) {
-    m_matrixID = glGetUniformLocation(shaderID, "CameraTransform");
+Camera::Camera() {
     m_position = glm::vec3(0, 0, -12);
     m_direction = glm::vec3(1, 0, 0);
     m_up = glm::vec3(0, 1, 0);
     m_FoV = 90.f;
     m_aspectRatio = 4.f/3.f;
+    m_viewProjection = glm::mat4(1.f);
 }
 
 glm::mat4 Camera::getViewMatrix() {
@@ -20,7 +22,20 @@ glm::mat4 Camera::getProjectionMatrix() {
     //return glm::ortho(-10.f, 10.f, -10.f, 10.f, 0.f, 100.f);
 }
 
-void Camera::update() {
-    glm::mat4 matrix = getProjectionMatrix()*getViewMatrix();
-    glUniformMatrix4fv(m_matrixID, 1, GL_FALSE, &matrix[0][0]);
+void Camera::update(UniformBuffers& uniforms) {
+    CameraBlock block;
+    block.m_view = getViewMatrix();
+    block.m_projection = getProjectionMatrix();
+    block.m_viewProjection = block.m_projection*block.m_view;
+    block.m_position = glm::vec4(m_position, 1.f);
+    uniforms.setCamera(block);
+    m_viewProjection = block.m_viewProjection;
+}
+
+float Camera::projectedSize(const BoundingSphere& sphere) const {
+    float distance = glm::length(sphere.m_center - m_position);
+    if (distance <= sphere.m_radius) {
+        return 1.f;
+    }
+    return sphere.m_radius/(distance*std::tan(0.5f*glm::radians(m_FoV)));
 }
@@ -7,18 +7,27 @@
 
 #include <glm/glm.hpp>
 
+#include "core/bounds.h"
+#include "core/uniform_buffers.h"
+
 class Camera {
 public:
     glm::vec3 m_position;
     glm::vec3 m_direction;
     glm::vec3 m_up;
     float m_FoV, m_aspectRatio;
-    GLuint m_matrixID;
+    /// Projection*view matrix of the last call to `update()`.
+    glm::mat4 m_viewProjection;
 
-    Camera(GLuint shaderID);
+    Camera();
     glm::mat4 getViewMatrix();
     glm::mat4 getProjectionMatrix();
-    void update();
+    /// Writes the camera block of the frame to `uniforms`.
+    void update(UniformBuffers& uniforms);
+    /// Approximates the fraction of the viewport height covered by a
+    /// sphere from its distance and the vertical field of view.
+    /// @return Screen size of the sphere, 1 if the camera is inside it.
+    float projectedSize(const BoundingSphere& sphere) const;
 };
 
 #endif
@@ -0,0 +1,193 @@
+#include "core/compute_integrator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "core/batch_renderer.h"
+#include "core/mesh.h"
+#include "core/render_stats.h"
+#include "core/shaders.h"
+
+bool ComputeIntegrator::isSupported() {
+    return GLEW_ARB_compute_shader && GLEW_ARB_shader_storage_buffer_object;
+}
+
+ComputeIntegrator::ComputeIntegrator() {
+    m_bodyCountLocation = m_stepsLocation = m_timestepLocation = m_alphaLocation = -1;
+    m_vertexbuffer = m_indexbuffer = 0;
+    m_bodyCount = 0;
+    m_positions = GLBuffer::create();
+    m_previousPositions = GLBuffer::create();
+    m_velocities = GLBuffer::create();
+    m_accelerations = GLBuffer::create();
+    m_transforms = GLBuffer::create();
+    m_vertexArray = GLVertexArray::create();
+}
+
+void ComputeIntegrator::releaseBuffers() {
+    m_program.reset();
+    m_positions.reset();
+    m_previousPositions.reset();
+    m_velocities.reset();
+    m_accelerations.reset();
+    m_transforms.reset();
+    m_vertexArray.reset();
+    m_bodyCount = 0;
+}
+
+bool ComputeIntegrator::load(const std::string& compute_file_path) {
+    m_program.reset(LoadComputeShader(compute_file_path));
+    if (!m_program) {
+        return false;
+    }
+
+    GLuint program = m_program.get();
+    const char* names[5] = {"PositionBlock", "PreviousPositionBlock", "VelocityBlock", "AccelerationBlock", "InstanceTransformBlock"};
+    const GLuint bindings[5] = {POSITION_BINDING, PREVIOUS_POSITION_BINDING, VELOCITY_BINDING, ACCELERATION_BINDING, INSTANCE_TRANSFORM_BINDING};
+    for (int i = 0; i < 5; i++) {
+        GLuint index = glGetProgramResourceIndex(program, GL_SHADER_STORAGE_BLOCK, names[i]);
+        if (index != GL_INVALID_INDEX) {
+            glShaderStorageBlockBinding(program, index, bindings[i]);
+        }
+    }
+    m_bodyCountLocation = glGetUniformLocation(program, "BodyCount");
+    m_stepsLocation = glGetUniformLocation(program, "Steps");
+    m_timestepLocation = glGetUniformLocation(program, "Timestep");
+    m_alphaLocation = glGetUniformLocation(program, "Alpha");
+    return true;
+}
+
+/// The state is stored as `vec4`s since std430 pads every `vec3` of an
+/// array to 16 bytes anyway, the fourth component is unused.
+bool ComputeIntegrator::upload(const PhysicsWorld& world) {
+    GLint max_groups = 65535;
+    glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_COUNT, 0, &max_groups);
+    size_t count = world.size();
+    if (count > static_cast<size_t>(max_groups)*WORK_GROUP_SIZE) {
+        std::cerr << "Too many bodies for one compute dispatch, at most "
+                  << static_cast<size_t>(max_groups)*WORK_GROUP_SIZE << " are supported.\n";
+        return false;
+    }
+
+    std::vector<glm::vec4> positions(count), velocities(count), accelerations(count);
+    for (size_t i = 0; i < count; i++) {
+        positions[i] = glm::vec4(world.getPosition(i), 1.f);
+        velocities[i] = glm::vec4(world.getVelocity(i), 0.f);
+        accelerations[i] = glm::vec4(world.m_accelerationX[i], world.m_accelerationY[i], world.m_accelerationZ[i], 0.f);
+    }
+
+    GLsizeiptr size = static_cast<GLsizeiptr>(count*sizeof(glm::vec4));
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_positions.get());
+    glBufferData(GL_SHADER_STORAGE_BUFFER, size, positions.data(), GL_DYNAMIC_COPY);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_previousPositions.get());
+    glBufferData(GL_SHADER_STORAGE_BUFFER, size, positions.data(), GL_DYNAMIC_COPY);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_velocities.get());
+    glBufferData(GL_SHADER_STORAGE_BUFFER, size, velocities.data(), GL_DYNAMIC_COPY);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_accelerations.get());
+    glBufferData(GL_SHADER_STORAGE_BUFFER, size, accelerations.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_transforms.get());
+    glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(count*sizeof(glm::mat4)), NULL, GL_DYNAMIC_COPY);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    m_bodyCount = static_cast<GLuint>(count);
+    // the transforms are only written by the first update
+    update(0.f, 0, 1.f);
+    return true;
+}
+
+void ComputeIntegrator::download(PhysicsWorld& world) const {
+    size_t count = std::min(world.size(), static_cast<size_t>(m_bodyCount));
+    std::vector<glm::vec4> positions(count), velocities(count);
+    GLsizeiptr size = static_cast<GLsizeiptr>(count*sizeof(glm::vec4));
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_positions.get());
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, positions.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_velocities.get());
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, velocities.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    for (size_t i = 0; i < count; i++) {
+        world.m_positionX[i] = positions[i].x;
+        world.m_positionY[i] = positions[i].y;
+        world.m_positionZ[i] = positions[i].z;
+        world.m_velocityX[i] = velocities[i].x;
+        world.m_velocityY[i] = velocities[i].y;
+        world.m_velocityZ[i] = velocities[i].z;
+    }
+}
+
+size_t ComputeIntegrator::size() const {
+    return m_bodyCount;
+}
+
+/// The bodies do not interact, so every invocation runs all the steps of
+/// its body and one dispatch covers the whole frame whatever the number
+/// of steps.
+void ComputeIntegrator::update(float dt, unsigned int steps, float alpha) {
+    if ((m_bodyCount == 0) || !m_program) {
+        return;
+    }
+
+    glUseProgram(m_program.get());
+    glUniform1ui(m_bodyCountLocation, m_bodyCount);
+    glUniform1ui(m_stepsLocation, steps);
+    glUniform1f(m_timestepLocation, dt);
+    glUniform1f(m_alphaLocation, alpha);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, POSITION_BINDING, m_positions.get());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, PREVIOUS_POSITION_BINDING, m_previousPositions.get());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VELOCITY_BINDING, m_velocities.get());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ACCELERATION_BINDING, m_accelerations.get());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCE_TRANSFORM_BINDING, m_transforms.get());
+    glDispatchCompute((m_bodyCount + WORK_GROUP_SIZE - 1)/WORK_GROUP_SIZE, 1, 1);
+
+    // the transforms are read as vertex attributes by the next draw
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+/// The instance attributes point at the transform buffer for good, so the
+/// integrator keeps a vertex array of its own instead of repointing the
+/// model's, which may be shared with a `BatchRenderer`.
+void ComputeIntegrator::attachModel(const Model& model) {
+    glBindVertexArray(m_vertexArray.get());
+    glBindBuffer(GL_ARRAY_BUFFER, model.m_vertexbuffer);
+    Mesh::Format::setAttributes();
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model.m_indexbuffer);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_transforms.get());
+    for (GLuint column = 0; column < 4; column++) {
+        GLuint location = BatchRenderer::INSTANCE_ATTRIBUTE + column;
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                              reinterpret_cast<void*>(static_cast<std::uintptr_t>(column*sizeof(glm::vec4))));
+    }
+    m_vertexbuffer = model.m_vertexbuffer;
+    m_indexbuffer = model.m_indexbuffer;
+    RenderStats::getInstance()->m_attributeCalls += 12;
+}
+
+void ComputeIntegrator::draw(const Model& model, UniformBuffers& uniforms) {
+    if (m_bodyCount == 0) {
+        return;
+    }
+
+    RenderStats* stats = RenderStats::getInstance();
+    if ((model.m_vertexbuffer != m_vertexbuffer) || (model.m_indexbuffer != m_indexbuffer)) {
+        attachModel(model);
+    } else {
+        glBindVertexArray(m_vertexArray.get());
+    }
+    stats->m_bindCalls++;
+
+    DrawBlock instanced = DrawBlock();
+    instanced.m_modelSpaceToWorldSpace = glm::mat4(1.f);
+    instanced.m_instanced = GL_TRUE;
+    size_t index = uniforms.addDraw(instanced);
+    uniforms.flush();
+    uniforms.bindDraw(index);
+    model.drawModelInstanced(static_cast<GLsizei>(m_bodyCount));
+}
@@ -0,0 +1,93 @@
+#ifndef COMPUTE_INTEGRATOR_H
+#define COMPUTE_INTEGRATOR_H
+
+#include <string>
+
+// keep this before all other OpenGL libraries
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+#include "core/gl_object.h"
+#include "core/model.h"
+#include "core/physics_world.h"
+#include "core/uniform_buffers.h"
+
+/// Integrates bodies on the GPU with a compute shader, for workloads too
+/// large to update on the CPU and upload every frame. The positions,
+/// velocities and accelerations live in shader storage buffers and only
+/// cross the bus when they are uploaded or read back. Each step is the
+/// same velocity Verlet step with the same fake floor as `Object::update`
+/// and `PhysicsWorld::step`, and the shader interpolates between the last
+/// two steps like `Object::interpolate`.
+///
+/// The shader also writes the translation matrix of every body to a
+/// buffer that is read as the per-instance transform attribute, so the
+/// bodies are drawn with one instanced draw without the transforms
+/// passing through the CPU. The bodies are not culled.
+///
+/// Needs `ARB_compute_shader` and `ARB_shader_storage_buffer_object`,
+/// see `isSupported()`.
+class ComputeIntegrator {
+public:
+    /// Shader storage bindings of the blocks of the compute shader, after
+    /// the binding of `IndirectRenderer::TRANSFORM_BINDING`.
+    static constexpr GLuint POSITION_BINDING = 1;
+    static constexpr GLuint PREVIOUS_POSITION_BINDING = 2;
+    static constexpr GLuint VELOCITY_BINDING = 3;
+    static constexpr GLuint ACCELERATION_BINDING = 4;
+    static constexpr GLuint INSTANCE_TRANSFORM_BINDING = 5;
+    /// Must match `local_size_x` of the compute shader.
+    static constexpr GLuint WORK_GROUP_SIZE = 64;
+private:
+    GLProgram m_program;
+    GLint m_bodyCountLocation;
+    GLint m_stepsLocation;
+    GLint m_timestepLocation;
+    GLint m_alphaLocation;
+    GLBuffer m_positions;
+    GLBuffer m_previousPositions;
+    GLBuffer m_velocities;
+    GLBuffer m_accelerations;
+    GLBuffer m_transforms;
+    /// Vertex array with the vertex layout of the drawn model and the
+    /// transforms as instance attributes, set up for the buffers below.
+    GLVertexArray m_vertexArray;
+    GLuint m_vertexbuffer;
+    GLuint m_indexbuffer;
+    GLuint m_bodyCount;
+
+    /// Points the vertex array at the buffers of the model.
+    void attachModel(const Model& model);
+public:
+    /// @return True if the driver has the extensions the integrator needs.
+    static bool isSupported();
+
+    ComputeIntegrator();
+    void releaseBuffers();
+
+    /// Compiles the compute shader and binds its blocks.
+    /// @return False if it failed to compile or link.
+    bool load(const std::string& compute_file_path);
+
+    /// Replaces the bodies on the GPU with those of the world, each body
+    /// starts with its previous position at its position.
+    /// @return False if the world has more bodies than one dispatch covers.
+    bool upload(const PhysicsWorld& world);
+    /// Copies the positions and velocities back into a world with the same
+    /// number of bodies. Blocks until the GPU has finished integrating, so
+    /// it is meant for checking the results, not for every frame.
+    void download(PhysicsWorld& world) const;
+    /// @return Number of bodies on the GPU.
+    size_t size() const;
+
+    /// Advances every body by `steps` velocity Verlet steps and writes the
+    /// transforms interpolated between the last two steps.
+    void update(float dt, unsigned int steps, float alpha);
+    /// Draws an instance of the model at every body. The model's vertices
+    /// must be in the `Mesh::Format` layout and must not be streamed, and
+    /// the bound program must read the `InstanceTransform` attribute when
+    /// the draw block is instanced, like `BatchRenderer`'s programs.
+    void draw(const Model& model, UniformBuffers& uniforms);
+};
+
+#endif
@@ -0,0 +1,40 @@
+#include "core/fixed_step.h"
+
+#include <cmath>
+
+FixedStepScheduler::FixedStepScheduler(double tickRate, unsigned int maxSteps) {
+    m_step = static_cast<std::int64_t>(std::llround(1e9/tickRate));
+    m_accumulator = 0;
+    m_maxSteps = maxSteps;
+    m_ticks = 0;
+    m_droppedSteps = 0;
+}
+
+unsigned int FixedStepScheduler::advance(double frameTime) {
+    m_accumulator += static_cast<std::int64_t>(std::llround(1e9*frameTime));
+    std::int64_t steps = m_accumulator/m_step;
+    m_accumulator -= steps*m_step;
+
+    if (steps > static_cast<std::int64_t>(m_maxSteps)) {
+        m_droppedSteps += static_cast<std::uint64_t>(steps - m_maxSteps);
+        steps = m_maxSteps;
+    }
+    m_ticks += static_cast<std::uint64_t>(steps);
+    return static_cast<unsigned int>(steps);
+}
+
+float FixedStepScheduler::getStep() const {
+    return static_cast<float>(1e-9*static_cast<double>(m_step));
+}
+
+float FixedStepScheduler::getAlpha() const {
+    return static_cast<float>(static_cast<double>(m_accumulator)/static_cast<double>(m_step));
+}
+
+std::uint64_t FixedStepScheduler::getTicks() const {
+    return m_ticks;
+}
+
+std::uint64_t FixedStepScheduler::getDroppedSteps() const {
+    return m_droppedSteps;
+}
@@ -0,0 +1,43 @@
+#ifndef FIXED_STEP_H
+#define FIXED_STEP_H
+
+#include <cstdint>
+
+/// Schedules a simulation that advances in fixed time steps independently
+/// of the frame rate. Every frame the elapsed time is added to an
+/// accumulator and the simulation runs as many whole steps as fit in it.
+/// The time left over is a fraction of a step, which the renderer uses to
+/// interpolate between the previous and the current simulation state.
+///
+/// Times are accumulated as integer nanoseconds, so the same sequence of
+/// frame times always gives the same sequence of steps.
+class FixedStepScheduler {
+private:
+    std::int64_t m_step;
+    std::int64_t m_accumulator;
+    unsigned int m_maxSteps;
+    std::uint64_t m_ticks;
+    std::uint64_t m_droppedSteps;
+public:
+    /// @param tickRate Number of simulation steps per second.
+    /// @param maxSteps Most steps run in a single frame. After a long
+    /// frame the simulation falls behind instead of spending ever longer
+    /// frames catching up.
+    FixedStepScheduler(double tickRate=120.0, unsigned int maxSteps=8);
+
+    /// Adds the time of a frame to the accumulator.
+    /// @param frameTime Time since the previous frame in seconds.
+    /// @return Number of steps to simulate this frame.
+    unsigned int advance(double frameTime);
+    /// @return Length of a step in seconds.
+    float getStep() const;
+    /// @return Fraction of a step the render time is past the current
+    /// simulation state, in [0, 1).
+    float getAlpha() const;
+    /// @return Number of steps simulated since the scheduler was created.
+    std::uint64_t getTicks() const;
+    /// @return Number of steps skipped because a frame took too long.
+    std::uint64_t getDroppedSteps() const;
+};
+
+#endif
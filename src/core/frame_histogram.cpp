@@ -0,0 +1,115 @@
+#include "core/frame_histogram.h"
+
+#include <cmath>
+
+FrameHistogram::FrameHistogram() {
+    reset();
+}
+
+/// Values below `SUB_BUCKET_COUNT` map directly to a bucket. Larger
+/// values are shifted right until they fit in the upper half of the sub
+/// buckets and the shift selects the group of buckets.
+int FrameHistogram::bucketIndex(std::uint64_t value) {
+    if (value < static_cast<std::uint64_t>(SUB_BUCKET_COUNT)) {
+        return static_cast<int>(value);
+    }
+    int magnitude = 63 - __builtin_clzll(value);
+    int shift = magnitude - SUB_BUCKET_BITS + 1;
+    return shift*SUB_BUCKET_HALF_COUNT + static_cast<int>(value >> shift);
+}
+
+std::uint64_t FrameHistogram::bucketLowerBound(int index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return static_cast<std::uint64_t>(index);
+    }
+    int shift = index/SUB_BUCKET_HALF_COUNT - 1;
+    std::uint64_t sub_bucket = static_cast<std::uint64_t>(index - shift*SUB_BUCKET_HALF_COUNT);
+    return sub_bucket << shift;
+}
+
+std::uint64_t FrameHistogram::bucketUpperBound(int index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return static_cast<std::uint64_t>(index) + 1;
+    }
+    int shift = index/SUB_BUCKET_HALF_COUNT - 1;
+    return bucketLowerBound(index) + (std::uint64_t(1) << shift);
+}
+
+void FrameHistogram::record(double seconds) {
+    double microseconds = std::round(seconds*1e6);
+    std::uint64_t value = MAX_VALUE;
+    if (microseconds < static_cast<double>(MAX_VALUE)) {
+        value = (microseconds > 0) ? static_cast<std::uint64_t>(microseconds) : 0;
+    }
+    m_counts[static_cast<size_t>(bucketIndex(value))]++;
+    m_total++;
+    m_sum += seconds;
+
+    if (seconds < m_min) {
+        m_min = seconds;
+    }
+    if (seconds > m_max) {
+        m_max = seconds;
+    }
+}
+
+void FrameHistogram::reset() {
+    m_counts.fill(0);
+    m_total = 0;
+    m_sum = 0;
+    m_min = INFINITY, m_max = -INFINITY;
+}
+
+std::uint64_t FrameHistogram::count() const {
+    return m_total;
+}
+
+double FrameHistogram::min() const {
+    return m_min;
+}
+
+double FrameHistogram::max() const {
+    return m_max;
+}
+
+double FrameHistogram::mean() const {
+    if (m_total == 0) {
+        return 0;
+    }
+    return m_sum/static_cast<double>(m_total);
+}
+
+double FrameHistogram::percentile(double percent) const {
+    if (m_total == 0) {
+        return 0;
+    }
+
+    // rank of the percentile counting from one
+    std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(percent/100*static_cast<double>(m_total)));
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    std::uint64_t seen = 0;
+    for (int index = 0; index < BUCKET_COUNT; index++) {
+        seen += m_counts[static_cast<size_t>(index)];
+        if (seen >= rank) {
+            // the bucket bound can overshoot the largest recorded value
+            double upper = static_cast<double>(bucketUpperBound(index))*1e-6;
+            return (upper < m_max) ? upper : m_max;
+        }
+    }
+    return m_max;
+}
+
+void FrameHistogram::exportCSV(std::ostream& stream) const {
+    stream << "lower (ms),upper (ms),count\n";
+    for (int index = 0; index < BUCKET_COUNT; index++) {
+        std::uint64_t bucket_count = m_counts[static_cast<size_t>(index)];
+        if (bucket_count > 0) {
+            stream << static_cast<double>(bucketLowerBound(index))*1e-3 << ","
+                   << static_cast<double>(bucketUpperBound(index))*1e-3 << ","
+                   << bucket_count << "\n";
+        }
+    }
+}
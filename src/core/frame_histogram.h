@@ -0,0 +1,59 @@
+#ifndef FRAME_HISTOGRAM_H
+#define FRAME_HISTOGRAM_H
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+/// A fixed size log-linear histogram of frame times in the style of
+/// HdrHistogram. Times are recorded with microsecond resolution, values
+/// below 128 µs get a bucket each and above that every power of two is
+/// split into 64 buckets, so every bucket is within 1.6% of the values
+/// it holds. Recording never allocates.
+class FrameHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 7;
+    static constexpr int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static constexpr int SUB_BUCKET_HALF_COUNT = SUB_BUCKET_COUNT/2;
+    /// Largest recordable time in microseconds, larger times are clamped.
+    static constexpr std::uint64_t MAX_VALUE = (std::uint64_t(1) << 26) - 1;
+    static constexpr int BUCKET_COUNT = (26 - SUB_BUCKET_BITS + 1)*SUB_BUCKET_HALF_COUNT + SUB_BUCKET_HALF_COUNT;
+private:
+    std::array<std::uint64_t, BUCKET_COUNT> m_counts;
+    std::uint64_t m_total;
+    double m_sum, m_min, m_max;
+
+    static int bucketIndex(std::uint64_t value);
+    /// @return Smallest value in microseconds that falls in the bucket.
+    static std::uint64_t bucketLowerBound(int index);
+    /// @return Smallest value in microseconds of the next bucket.
+    static std::uint64_t bucketUpperBound(int index);
+public:
+    FrameHistogram();
+
+    /// Adds a time step to the histogram.
+    /// @param seconds Time step in seconds.
+    void record(double seconds);
+    void reset();
+
+    /// @return Number of recorded time steps.
+    std::uint64_t count() const;
+    /// @return Smallest recorded time step in seconds.
+    double min() const;
+    /// @return Largest recorded time step in seconds.
+    double max() const;
+    /// @return Mean of the recorded time steps in seconds, computed from
+    /// the exact values rather than the buckets.
+    double mean() const;
+    /// Finds the time step below which the given percent of the recorded
+    /// time steps fall.
+    /// @param percent Percentile in the range [0, 100].
+    /// @return Upper bound in seconds of the bucket holding the percentile.
+    double percentile(double percent) const;
+
+    /// Writes every non empty bucket as a line of comma separated lower
+    /// bound in ms, upper bound in ms and count.
+    void exportCSV(std::ostream& stream) const;
+};
+
+#endif
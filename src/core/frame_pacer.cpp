@@ -0,0 +1,99 @@
+#include "core/frame_pacer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <time.h>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/// The sleeps use absolute times so that a late wake up or an interrupted
+/// sleep does not push the following frames back.
+static double monotonicTime() {
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<double>(time.tv_sec) + 1e-9*static_cast<double>(time.tv_nsec);
+}
+
+static void sleepUntil(double time) {
+    timespec target;
+    double seconds = std::floor(time);
+    target.tv_sec = static_cast<time_t>(seconds);
+    target.tv_nsec = static_cast<long>(1e9*(time - seconds));
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr) == EINTR) {
+    }
+}
+
+FramePacer::FramePacer(double frameRate) {
+    m_budget = 1.0/frameRate;
+    m_frameStart = monotonicTime();
+    m_deadline = m_frameStart + m_budget;
+    m_meanWork = m_workVariance = 0;
+    m_margin = MAX_MARGIN;
+
+    m_startErrorSum = m_maxStartError = 0;
+    m_lateSum = m_maxLate = 0;
+    m_previousUpdate = m_frameStart;
+    m_frameCount = m_missedCount = 0;
+    m_loopLog = LoopLog::getInstance();
+}
+
+void FramePacer::beginFrame() {
+    // start early enough for all but the slowest frames to finish in time
+    double predicted_work = std::min(m_meanWork + 2*std::sqrt(m_workVariance), m_budget);
+    double start = m_deadline - predicted_work;
+
+    double wake = start - m_margin;
+    if (wake > monotonicTime()) {
+        sleepUntil(wake);
+        double latency = monotonicTime() - wake;
+        m_margin = std::clamp(std::max(1.5*latency, 0.99*m_margin), MIN_MARGIN, MAX_MARGIN);
+    }
+    while (monotonicTime() < start) {
+#if defined(__SSE2__)
+        _mm_pause();
+#endif
+    }
+    m_frameStart = monotonicTime();
+    double start_error = std::max(m_frameStart - start, 0.0);
+    m_startErrorSum += start_error;
+    m_maxStartError = std::max(m_maxStartError, start_error);
+}
+
+void FramePacer::endFrame() {
+    double now = monotonicTime();
+    double work = now - m_frameStart;
+    const double weight = 0.05;
+    double difference = work - m_meanWork;
+    m_meanWork += weight*difference;
+    m_workVariance = (1 - weight)*(m_workVariance + weight*difference*difference);
+
+    double late = std::max(now - m_deadline, 0.0);
+    m_lateSum += late;
+    m_maxLate = std::max(m_maxLate, late);
+    m_frameCount++;
+
+    m_deadline += m_budget;
+    if (m_deadline < now) {
+        m_deadline = now + m_budget;
+        m_missedCount++;
+    }
+
+    if (now - m_previousUpdate >= 1.0) {
+        double frames = static_cast<double>(m_frameCount);
+        m_loopLog->m_log << "Pacing (in ms) start error [mean | max]: [" << 1000*m_startErrorSum/frames
+                         << " | " << 1000*m_maxStartError << "] late [mean | max]: [" << 1000*m_lateSum/frames
+                         << " | " << 1000*m_maxLate << "] missed: " << m_missedCount
+                         << " wake margin: " << 1000*m_margin << "\n";
+        m_startErrorSum = m_maxStartError = 0;
+        m_lateSum = m_maxLate = 0;
+        m_frameCount = m_missedCount = 0;
+        m_previousUpdate = now;
+    }
+}
+
+double FramePacer::getMargin() const {
+    return m_margin;
+}
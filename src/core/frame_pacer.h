@@ -0,0 +1,56 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include "core/looplog.h"
+
+/// Paces the render loop to a fixed frame budget while keeping the CPU
+/// idle for the time the frames do not need.
+///
+/// Each frame is started late enough that it is predicted to finish just
+/// at its deadline, which also keeps the input read at the start of the
+/// frame as fresh as possible. The prediction follows the measured CPU
+/// time of recent frames. The wait is a `clock_nanosleep` that wakes
+/// `m_margin` early followed by a short spin to the exact start time. The
+/// margin grows to cover the wake up latency seen on the system and
+/// slowly shrinks again when the latency drops, so that as little time
+/// as possible is spent spinning.
+///
+/// About once a second the pacing error is added to the `LoopLog`
+/// buffer. It is reported as how far frames started from their planned
+/// start, which is the precision of the wait, and how late frames ended
+/// after their deadline. A frame that misses its deadline by more than a
+/// budget moves the following deadlines instead of rushing the next
+/// frames to catch up.
+class FramePacer {
+private:
+    double m_budget;
+    /// Time the current frame should end at.
+    double m_deadline;
+    double m_frameStart;
+    /// Moving mean and variance of the CPU time of a frame.
+    double m_meanWork, m_workVariance;
+    double m_margin;
+
+    double m_startErrorSum, m_maxStartError;
+    double m_lateSum, m_maxLate, m_previousUpdate;
+    unsigned int m_frameCount, m_missedCount;
+    LoopLog* m_loopLog;
+public:
+    static constexpr double MIN_MARGIN = 50e-6;
+    static constexpr double MAX_MARGIN = 2e-3;
+
+    /// @param frameRate Target number of frames per second.
+    FramePacer(double frameRate = 60.0);
+
+    /// Waits until the next frame should start, should be called at the
+    /// start of every frame.
+    void beginFrame();
+    /// Records the end of the frame, should be called after the frame has
+    /// been presented.
+    void endFrame();
+    /// @return Time in seconds the pacer currently wakes before the start
+    /// of a frame to spin.
+    double getMargin() const;
+};
+
+#endif
@@ -1,12 +1,21 @@
 #include "core/frame_timer.h"
 
+#include <chrono>
 #include <cmath>
-#include <GLFW/glfw3.h>
-
+#include <fstream>
+#include <iostream>
+#include <utility>
 #include "core/looplog.h"
 
+/// Seconds on a monotonic clock since the first call. Used instead of
+/// glfwGetTime() so the timers also work without GLFW in headless mode.
+static double currentTime() {
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
 BasicTimer::BasicTimer() {
-    m_time = glfwGetTime();
+    m_time = currentTime();
     m_previous_time = m_previous_update = m_time;
     m_frame_count = 0;
 
@@ -16,7 +25,7 @@ BasicTimer::BasicTimer() {
 double BasicTimer::timer() {
     m_frame_count++;
     m_previous_time = m_time;
-    m_time = glfwGetTime();
+    m_time = currentTime();
 
     if (m_time - m_previous_update >= 1.0f) {
         m_loopLog->m_log << "FPS: " << static_cast<double>(m_frame_count)/(m_time - m_previous_update) << " Δt (in ms) : " << (m_time - m_previous_update)/static_cast<double>(m_frame_count) << "\n";
@@ -40,7 +49,7 @@ void AdvancedTimer::resetWelford() {
 }
 
 AdvancedTimer::AdvancedTimer() {
-    m_time = glfwGetTime();
+    m_time = currentTime();
     m_previous_time = m_previous_update = m_time;
     resetWelford();
 
@@ -52,7 +61,7 @@ double AdvancedTimer::timer() {
     m_previous_time = m_time;
     m_previous_mean_dt = m_mean_dt;
     m_previous_M2 = m_current_M2;
-    m_time = glfwGetTime();
+    m_time = currentTime();
 
     //Welford' online algorith for variance
     double dt = m_time - m_previous_time;
@@ -79,3 +88,63 @@ double AdvancedTimer::timer() {
 double AdvancedTimer::getTime() const {
     return m_time;
 }
+
+HistogramTimer::HistogramTimer(std::vector<double> percentiles, double frameBudget)
+    : m_percentiles(std::move(percentiles)) {
+    m_time = currentTime();
+    m_previous_time = m_previous_update = m_time;
+    m_frame_budget = frameBudget;
+    m_over_budget = m_total_over_budget = 0;
+
+    m_loopLog = LoopLog::getInstance();
+}
+
+double HistogramTimer::timer() {
+    m_previous_time = m_time;
+    m_time = currentTime();
+
+    double dt = m_time - m_previous_time;
+    m_window_histogram.record(dt);
+    m_total_histogram.record(dt);
+    if (dt > m_frame_budget) {
+        m_over_budget++;
+        m_total_over_budget++;
+    }
+
+    if (m_time - m_previous_update >= 1.0f) {
+        m_loopLog->m_log << "FPS: " << static_cast<double>(m_window_histogram.count())/(m_time - m_previous_update) << "\n";
+        m_loopLog->m_log << "Δt (in ms) :";
+        for (double percentile : m_percentiles) {
+            m_loopLog->m_log << " p" << percentile << ": " << 1000*m_window_histogram.percentile(percentile);
+        }
+        m_loopLog->m_log << " [Min|Max]: [" << 1000*m_window_histogram.min() << " | " << 1000*m_window_histogram.max() << "]"
+                         << " over " << 1000*m_frame_budget << " ms: " << m_over_budget << "\n";
+        m_previous_update = m_time;
+        m_window_histogram.reset();
+        m_over_budget = 0;
+    }
+
+    return dt;
+}
+
+double HistogramTimer::getTime() const {
+    return m_time;
+}
+
+const FrameHistogram& HistogramTimer::getHistogram() const {
+    return m_total_histogram;
+}
+
+std::uint64_t HistogramTimer::getOverBudgetCount() const {
+    return m_total_over_budget;
+}
+
+void HistogramTimer::exportHistogram(const std::string& path) const {
+    std::ofstream stream(path);
+    if (!stream.is_open()) {
+        std::cerr << "Failed to open '" << path << "'.\n";
+        return;
+    }
+    m_total_histogram.exportCSV(stream);
+    std::clog << "Wrote frame time histogram to " << path << "\n";
+}
@@ -1,6 +1,10 @@
 #ifndef FRAME_TIMER_H
 #define FRAME_TIMER_H
 
+#include <string>
+#include <vector>
+
+#include "core/frame_histogram.h"
 #include "core/looplog.h"
 
 /// An interface for timming the render loop. One of the implementations
@@ -16,7 +20,7 @@ public:
     /// `LoopLog` buffer.
     /// @return Time since the previous invocation of `timer()`.
     virtual double timer() = 0;
-    /// @return The time since the GLFW window was created.
+    /// @return The time in seconds since the first timer was created.
     virtual double getTime() const = 0;
 };
 
@@ -54,4 +58,34 @@ public:
     double getTime() const override;
 };
 
+/// This implementation of `FrameTimer` records every time step in a
+/// fixed memory histogram and adds the frame rate, the requested
+/// percentiles of the time step and the number of frames over budget to
+/// the `LoopLog` buffer. A second histogram covering the whole run can
+/// be exported with `exportHistogram()`.
+class HistogramTimer : public FrameTimer {
+private:
+    double m_time, m_previous_time, m_previous_update;
+    double m_frame_budget;
+    std::uint64_t m_over_budget, m_total_over_budget;
+    std::vector<double> m_percentiles;
+    FrameHistogram m_window_histogram, m_total_histogram;
+
+    LoopLog* m_loopLog;
+public:
+    /// @param percentiles Percentiles of the time step to report.
+    /// @param frameBudget Time steps longer than this, in seconds, are
+    /// counted as over budget.
+    HistogramTimer(std::vector<double> percentiles = {50, 99, 99.9}, double frameBudget = 1.0/60.0);
+    double timer() override;
+    double getTime() const override;
+
+    /// @return Histogram of every time step since the timer was created.
+    const FrameHistogram& getHistogram() const;
+    /// @return Number of frames over budget since the timer was created.
+    std::uint64_t getOverBudgetCount() const;
+    /// Writes the histogram of the whole run to a CSV file.
+    void exportHistogram(const std::string& path) const;
+};
+
 #endif
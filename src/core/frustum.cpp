@@ -0,0 +1,95 @@
+#include "core/frustum.h"
+
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/// A point is inside the clip volume if -w <= x, y, z <= w. With the rows
+/// r0 to r3 of the matrix these are the world space planes r3 + r0,
+/// r3 - r0, r3 + r1, r3 - r1, r3 + r2 and r3 - r2, which are normalized so
+/// distances to them can be compared with radii.
+Frustum::Frustum(const glm::mat4& viewProjection) {
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; i++) {
+        rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    }
+
+    for (size_t i = 0; i < PLANE_COUNT; i++) {
+        glm::vec4 plane = (i%2 == 0) ? rows[3] + rows[i/2] : rows[3] - rows[i/2];
+        float length = std::sqrt(plane.x*plane.x + plane.y*plane.y + plane.z*plane.z);
+        m_normalX[i] = plane.x/length;
+        m_normalY[i] = plane.y/length;
+        m_normalZ[i] = plane.z/length;
+        m_distance[i] = plane.w/length;
+    }
+    for (size_t i = PLANE_COUNT; i < PADDED_PLANE_COUNT; i++) {
+        m_normalX[i] = m_normalY[i] = m_normalZ[i] = 0.f;
+        m_distance[i] = 1.f;
+    }
+}
+
+/// The box is projected onto each plane normal, giving the distance of
+/// its center from the plane and its radius along the normal.
+Frustum::Classification Frustum::classify(const BoundingBox& box) const {
+    glm::vec3 center = box.center();
+    glm::vec3 extent = box.extent();
+
+#if defined(__SSE2__)
+    const __m128 sign_mask = _mm_set1_ps(-0.f);
+    const __m128 cx = _mm_set1_ps(center.x), cy = _mm_set1_ps(center.y), cz = _mm_set1_ps(center.z);
+    const __m128 ex = _mm_set1_ps(extent.x), ey = _mm_set1_ps(extent.y), ez = _mm_set1_ps(extent.z);
+    const __m128 zero = _mm_setzero_ps();
+    int outside = 0, intersecting = 0;
+    for (size_t i = 0; i < PADDED_PLANE_COUNT; i += 4) {
+        __m128 nx = _mm_load_ps(m_normalX + i), ny = _mm_load_ps(m_normalY + i), nz = _mm_load_ps(m_normalZ + i);
+        __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)),
+                                     _mm_add_ps(_mm_mul_ps(nz, cz), _mm_load_ps(m_distance + i)));
+        __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(sign_mask, nx), ex),
+                                              _mm_mul_ps(_mm_andnot_ps(sign_mask, ny), ey)),
+                                   _mm_mul_ps(_mm_andnot_ps(sign_mask, nz), ez));
+        outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+        intersecting |= _mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(distance, radius), zero));
+    }
+    if (outside != 0) {
+        return OUTSIDE;
+    }
+    return (intersecting != 0) ? INTERSECTS : INSIDE;
+#else
+    Classification result = INSIDE;
+    for (size_t i = 0; i < PLANE_COUNT; i++) {
+        float distance = m_normalX[i]*center.x + m_normalY[i]*center.y + m_normalZ[i]*center.z + m_distance[i];
+        float radius = std::fabs(m_normalX[i])*extent.x + std::fabs(m_normalY[i])*extent.y + std::fabs(m_normalZ[i])*extent.z;
+        if (distance + radius < 0.f) {
+            return OUTSIDE;
+        }
+        if (distance - radius < 0.f) {
+            result = INTERSECTS;
+        }
+    }
+    return result;
+#endif
+}
+
+bool Frustum::intersects(const BoundingSphere& sphere) const {
+#if defined(__SSE2__)
+    const __m128 cx = _mm_set1_ps(sphere.m_center.x), cy = _mm_set1_ps(sphere.m_center.y), cz = _mm_set1_ps(sphere.m_center.z);
+    const __m128 negative_radius = _mm_set1_ps(-sphere.m_radius);
+    int outside = 0;
+    for (size_t i = 0; i < PADDED_PLANE_COUNT; i += 4) {
+        __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_load_ps(m_normalX + i), cx), _mm_mul_ps(_mm_load_ps(m_normalY + i), cy)),
+                                     _mm_add_ps(_mm_mul_ps(_mm_load_ps(m_normalZ + i), cz), _mm_load_ps(m_distance + i)));
+        outside |= _mm_movemask_ps(_mm_cmplt_ps(distance, negative_radius));
+    }
+    return outside == 0;
+#else
+    for (size_t i = 0; i < PLANE_COUNT; i++) {
+        float distance = m_normalX[i]*sphere.m_center.x + m_normalY[i]*sphere.m_center.y + m_normalZ[i]*sphere.m_center.z + m_distance[i];
+        if (distance < -sphere.m_radius) {
+            return false;
+        }
+    }
+    return true;
+#endif
+}
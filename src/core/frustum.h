@@ -0,0 +1,39 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+#include "core/bounds.h"
+
+/// The view frustum of a camera as six planes in world space, for testing
+/// bounding volumes against it. The planes are stored as a structure of
+/// arrays padded to eight, so a box or sphere is tested against four
+/// planes per instruction with SSE. The padding planes contain everything.
+class Frustum {
+public:
+    enum Classification { OUTSIDE, INTERSECTS, INSIDE };
+
+    static constexpr size_t PLANE_COUNT = 6;
+    static constexpr size_t PADDED_PLANE_COUNT = 8;
+private:
+    /// Plane normals pointing into the frustum and their distances from
+    /// the origin, a point p is inside a plane if dot(n, p) + d >= 0.
+    alignas(16) float m_normalX[PADDED_PLANE_COUNT];
+    alignas(16) float m_normalY[PADDED_PLANE_COUNT];
+    alignas(16) float m_normalZ[PADDED_PLANE_COUNT];
+    alignas(16) float m_distance[PADDED_PLANE_COUNT];
+public:
+    /// Extracts the planes from a projection*view matrix with OpenGL clip
+    /// space, as set by `Camera::update()`.
+    Frustum(const glm::mat4& viewProjection);
+
+    /// @return Whether the box is completely outside, partially inside or
+    /// completely inside the frustum. Boxes near the corners of the
+    /// frustum may be reported as intersecting while being outside.
+    Classification classify(const BoundingBox& box) const;
+    /// @return False if the sphere is completely outside the frustum.
+    bool intersects(const BoundingSphere& sphere) const;
+};
+
+#endif
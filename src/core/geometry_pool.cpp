@@ -0,0 +1,104 @@
+#include "core/geometry_pool.h"
+
+#include <algorithm>
+
+GeometryPool::GeometryPool(GLsizei vertexCapacity, GLsizei indexCapacity) {
+    m_vertexCapacity = vertexCapacity;
+    m_indexCapacity = indexCapacity;
+    m_vertexCount = m_indexCount = 0;
+
+    m_vertexArray = GLVertexArray::create();
+    m_vertexbuffer = GLBuffer::create();
+    m_indexbuffer = GLBuffer::create();
+    glBindVertexArray(m_vertexArray.get());
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexbuffer.get());
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertexCapacity)*Mesh::Format::stride, NULL, GL_STATIC_DRAW);
+    Mesh::Format::setAttributes();
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexbuffer.get());
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indexCapacity)*static_cast<GLsizeiptr>(sizeof(GLuint)), NULL, GL_STATIC_DRAW);
+    glBindVertexArray(0);
+}
+
+void GeometryPool::releaseBuffers() {
+    m_vertexArray.reset();
+    m_vertexbuffer.reset();
+    m_indexbuffer.reset();
+}
+
+/// Widens 16 bit indices straight into the mapped index buffer, so a
+/// mesh mapped from the cache is read once without a copy on the heap.
+/// If the buffer can not be mapped the indices are widened in chunks on
+/// the stack instead.
+void GeometryPool::widenIndices(const GLushort* indices, GLsizei indexCount, GLintptr offset, GLsizeiptr size) {
+    void* mapped = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    if (mapped != nullptr) {
+        GLuint* destination = static_cast<GLuint*>(mapped);
+        for (GLsizei i = 0; i < indexCount; i++) {
+            destination[i] = indices[i];
+        }
+        if (glUnmapBuffer(GL_COPY_WRITE_BUFFER) == GL_TRUE) {
+            return;
+        }
+        // the contents were lost while mapped, write them again
+    }
+
+    GLuint chunk[1024];
+    constexpr GLsizei chunk_size = static_cast<GLsizei>(sizeof(chunk)/sizeof(chunk[0]));
+    for (GLsizei first = 0; first < indexCount; first += chunk_size) {
+        GLsizei count = std::min(chunk_size, indexCount - first);
+        for (GLsizei i = 0; i < count; i++) {
+            chunk[i] = indices[first + i];
+        }
+        glBufferSubData(GL_COPY_WRITE_BUFFER, offset + static_cast<GLintptr>(first)*static_cast<GLintptr>(sizeof(GLuint)),
+                        static_cast<GLsizeiptr>(count)*static_cast<GLsizeiptr>(sizeof(GLuint)), chunk);
+    }
+}
+
+/// The uploads go through `GL_COPY_WRITE_BUFFER` so they do not change
+/// the element buffer of whatever vertex array is bound.
+bool GeometryPool::add(const Mesh& mesh, Model& model) {
+    if ((mesh.m_vertexCount > m_vertexCapacity - m_vertexCount) || (mesh.m_indexCount > m_indexCapacity - m_indexCount)) {
+        return false;
+    }
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_vertexbuffer.get());
+    glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(m_vertexCount)*Mesh::Format::stride, mesh.vertexBufferSize(), mesh.m_vertices);
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_indexbuffer.get());
+    GLintptr index_offset = static_cast<GLintptr>(m_indexCount)*static_cast<GLintptr>(sizeof(GLuint));
+    GLsizeiptr index_size = static_cast<GLsizeiptr>(mesh.m_indexCount)*static_cast<GLsizeiptr>(sizeof(GLuint));
+    if (mesh.m_indexType == GL_UNSIGNED_SHORT) {
+        widenIndices(static_cast<const GLushort*>(mesh.m_indices), mesh.m_indexCount, index_offset, index_size);
+    } else {
+        glBufferSubData(GL_COPY_WRITE_BUFFER, index_offset, index_size, mesh.m_indices);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    model = Model();
+    model.m_vertexArray = m_vertexArray.get();
+    model.m_vertexbuffer = m_vertexbuffer.get();
+    model.m_indexbuffer = m_indexbuffer.get();
+    model.m_setAttributes = &Mesh::Format::setAttributes;
+    model.m_vertexCount = mesh.m_vertexCount;
+    model.m_indexCount = mesh.m_indexCount;
+    model.m_indexType = GL_UNSIGNED_INT;
+    model.m_baseVertex = m_vertexCount;
+    model.m_firstIndex = static_cast<GLuint>(m_indexCount);
+    model.m_bounds = computeBounds(mesh.m_vertices, static_cast<size_t>(mesh.m_vertexCount), Mesh::Format::stride);
+
+    m_vertexCount += mesh.m_vertexCount;
+    m_indexCount += mesh.m_indexCount;
+    return true;
+}
+
+GLuint GeometryPool::getVertexArray() const {
+    return m_vertexArray.get();
+}
+
+GLsizei GeometryPool::getVertexCount() const {
+    return m_vertexCount;
+}
+
+GLsizei GeometryPool::getIndexCount() const {
+    return m_indexCount;
+}
@@ -0,0 +1,55 @@
+#ifndef GEOMETRY_POOL_H
+#define GEOMETRY_POOL_H
+
+// keep this before all other OpenGL libraries
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+#include "core/gl_object.h"
+#include "core/mesh.h"
+#include "core/model.h"
+
+/// One large vertex buffer and index buffer that the static meshes are
+/// suballocated from. The models of a pool share its vertex array and
+/// only differ in their base vertex and first index, so switching
+/// between them binds nothing and they can all be drawn by a single
+/// multi draw indirect call, see `IndirectRenderer`.
+///
+/// Space is handed out one mesh after another and only freed all at once
+/// by `releaseBuffers()`, which suits geometry loaded once at startup.
+/// Indices are always stored as `GL_UNSIGNED_INT` so every model of the
+/// pool has the same index type.
+class GeometryPool {
+private:
+    GLVertexArray m_vertexArray;
+    GLBuffer m_vertexbuffer;
+    GLBuffer m_indexbuffer;
+    GLsizei m_vertexCapacity;
+    GLsizei m_indexCapacity;
+    GLsizei m_vertexCount;
+    GLsizei m_indexCount;
+
+    /// Writes 16 bit indices as `GL_UNSIGNED_INT` to the index buffer,
+    /// which must be bound to `GL_COPY_WRITE_BUFFER`.
+    /// @param offset Offset in bytes of the first index in the buffer.
+    /// @param size Size in bytes of the widened indices.
+    void widenIndices(const GLushort* indices, GLsizei indexCount, GLintptr offset, GLsizeiptr size);
+public:
+    /// @param vertexCapacity Number of `Mesh::Format` vertices the pool holds.
+    /// @param indexCapacity Number of indices the pool holds.
+    GeometryPool(GLsizei vertexCapacity, GLsizei indexCapacity);
+    void releaseBuffers();
+
+    /// Uploads a mesh to the end of the pool.
+    /// @param model Set to draw the mesh from the pool's buffers, the
+    /// buffers stay owned by the pool.
+    /// @return False if the pool is too full for the mesh.
+    bool add(const Mesh& mesh, Model& model);
+
+    GLuint getVertexArray() const;
+    /// @return Number of vertices and indices in use.
+    GLsizei getVertexCount() const;
+    GLsizei getIndexCount() const;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef GL_OBJECT_H
+#define GL_OBJECT_H
+
+// keep this before all other OpenGL libraries
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+/// Owns the name of an OpenGL object and deletes it when destroyed or
+/// replaced. It can be moved but not copied, so every object has exactly
+/// one owner. `Traits` provides `create()` and `destroy(GLuint)`.
+///
+/// The objects have to be released while their context is still current,
+/// owners that outlive the context should call `reset()` before it is
+/// destroyed.
+template<typename Traits>
+class GLObject {
+private:
+    GLuint m_name = 0;
+public:
+    GLObject() = default;
+    /// Takes ownership of an existing object.
+    explicit GLObject(GLuint name) : m_name(name) {}
+    ~GLObject() { reset(); }
+
+    GLObject(const GLObject&) = delete;
+    GLObject& operator=(const GLObject&) = delete;
+    GLObject(GLObject&& other) noexcept : m_name(other.m_name) { other.m_name = 0; }
+    GLObject& operator=(GLObject&& other) noexcept {
+        if (this != &other) {
+            reset(other.m_name);
+            other.m_name = 0;
+        }
+        return *this;
+    }
+
+    /// @return A new object.
+    static GLObject create() { return GLObject(Traits::create()); }
+
+    GLuint get() const { return m_name; }
+    explicit operator bool() const { return m_name != 0; }
+    /// Deletes the owned object, if any, and takes ownership of `name`.
+    void reset(GLuint name=0) {
+        if (m_name != 0) {
+            Traits::destroy(m_name);
+        }
+        m_name = name;
+    }
+    /// Gives up ownership without deleting the object.
+    /// @return The name of the object.
+    GLuint release() {
+        GLuint name = m_name;
+        m_name = 0;
+        return name;
+    }
+};
+
+struct GLBufferTraits {
+    static GLuint create() { GLuint name = 0; glGenBuffers(1, &name); return name; }
+    static void destroy(GLuint name) { glDeleteBuffers(1, &name); }
+};
+
+struct GLVertexArrayTraits {
+    static GLuint create() { GLuint name = 0; glGenVertexArrays(1, &name); return name; }
+    static void destroy(GLuint name) { glDeleteVertexArrays(1, &name); }
+};
+
+struct GLProgramTraits {
+    static GLuint create() { return glCreateProgram(); }
+    static void destroy(GLuint name) { glDeleteProgram(name); }
+};
+
+using GLBuffer = GLObject<GLBufferTraits>;
+using GLVertexArray = GLObject<GLVertexArrayTraits>;
+using GLProgram = GLObject<GLProgramTraits>;
+
+#endif
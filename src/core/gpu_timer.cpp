@@ -0,0 +1,187 @@
+#include "core/gpu_timer.h"
+
+#include <cstring>
+
+#include "core/profiler.h"
+
+GpuTimer::GpuTimer() {
+    for (Frame& frame : m_frames) {
+        glGenQueries(2, frame.m_queries);
+        for (Pass& pass : frame.m_passes) {
+            glGenQueries(2, pass.m_queries);
+        }
+        frame.m_passCount = 0;
+        frame.m_openPass = MAX_PASSES;
+        frame.m_pending = false;
+    }
+    m_currentFrame = 0;
+    m_gpuFrameTime = m_cpuFrameTime = 0;
+    m_frameSamples = m_droppedFrames = 0;
+    m_collectedCount = m_droppedCount = 0;
+    m_lastGpuFrameTime = 0;
+    m_previousUpdate = Profiler::now();
+    m_passStats.reserve(MAX_PASSES);
+
+    m_loopLog = LoopLog::getInstance();
+}
+
+void GpuTimer::releaseQueries() {
+    for (Frame& frame : m_frames) {
+        glDeleteQueries(2, frame.m_queries);
+        for (Pass& pass : frame.m_passes) {
+            glDeleteQueries(2, pass.m_queries);
+        }
+    }
+}
+
+bool GpuTimer::collectFrame(Frame& frame) {
+    // the end of frame query is issued last so once it is available all
+    // of the frame's queries are
+    GLuint available = GL_FALSE;
+    glGetQueryObjectuiv(frame.m_queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE) {
+        return false;
+    }
+
+    GLuint64 begin, end;
+    glGetQueryObjectui64v(frame.m_queries[0], GL_QUERY_RESULT, &begin);
+    glGetQueryObjectui64v(frame.m_queries[1], GL_QUERY_RESULT, &end);
+    m_lastGpuFrameTime = 1e-9*static_cast<double>(end - begin);
+    m_gpuFrameTime += m_lastGpuFrameTime;
+    m_cpuFrameTime += 1e-9*static_cast<double>(frame.m_cpuEnd - frame.m_cpuBegin);
+    m_frameSamples++;
+    m_collectedCount++;
+
+    for (unsigned int i = 0; i < frame.m_passCount; i++) {
+        Pass& pass = frame.m_passes[i];
+        glGetQueryObjectui64v(pass.m_queries[0], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(pass.m_queries[1], GL_QUERY_RESULT, &end);
+
+        PassStats* stats = nullptr;
+        for (PassStats& candidate : m_passStats) {
+            if (candidate.m_name == pass.m_name) {
+                stats = &candidate;
+                break;
+            }
+        }
+        if (stats == nullptr) {
+            m_passStats.push_back(PassStats{pass.m_name, 0, 0, 0, 0});
+            stats = &m_passStats.back();
+        }
+        stats->m_lastGpuTime = 1e-9*static_cast<double>(end - begin);
+        stats->m_gpuTime += stats->m_lastGpuTime;
+        stats->m_cpuTime += 1e-9*static_cast<double>(pass.m_cpuEnd - pass.m_cpuBegin);
+        stats->m_samples++;
+    }
+
+    frame.m_pending = false;
+    return true;
+}
+
+void GpuTimer::report() {
+    if (m_frameSamples == 0) {
+        return;
+    }
+    double frames = static_cast<double>(m_frameSamples);
+    m_loopLog->m_log << "GPU frame (in ms) : " << 1000*m_gpuFrameTime/frames
+                     << " CPU submit (in ms) : " << 1000*m_cpuFrameTime/frames
+                     << " dropped: " << m_droppedFrames << "\n";
+    for (PassStats& stats : m_passStats) {
+        if (stats.m_samples == 0) {
+            continue;
+        }
+        double samples = static_cast<double>(stats.m_samples);
+        m_loopLog->m_log << "  " << stats.m_name << " [GPU|CPU] (in ms) : [" << 1000*stats.m_gpuTime/samples
+                         << " | " << 1000*stats.m_cpuTime/samples << "]\n";
+        stats.m_gpuTime = stats.m_cpuTime = 0;
+        stats.m_samples = 0;
+    }
+    m_gpuFrameTime = m_cpuFrameTime = 0;
+    m_frameSamples = m_droppedFrames = 0;
+}
+
+void GpuTimer::beginFrame() {
+    // collect finished frames oldest first
+    for (unsigned int i = 1; i <= FRAME_LATENCY; i++) {
+        Frame& frame = m_frames[(m_currentFrame + i) % FRAME_LATENCY];
+        if (frame.m_pending && !collectFrame(frame)) {
+            break;
+        }
+    }
+
+    m_currentFrame = (m_currentFrame + 1) % FRAME_LATENCY;
+    Frame& frame = m_frames[m_currentFrame];
+    if (frame.m_pending) {
+        // the results are still not available after a full trip around
+        // the ring, waiting for them would stall so drop the frame
+        frame.m_pending = false;
+        m_droppedFrames++;
+        m_droppedCount++;
+    }
+
+    frame.m_passCount = 0;
+    frame.m_openPass = MAX_PASSES;
+    frame.m_cpuBegin = Profiler::now();
+    glQueryCounter(frame.m_queries[0], GL_TIMESTAMP);
+
+    std::uint64_t time = Profiler::now();
+    if (time - m_previousUpdate >= 1000000000) {
+        report();
+        m_previousUpdate = time;
+    }
+}
+
+void GpuTimer::endFrame() {
+    Frame& frame = m_frames[m_currentFrame];
+    if (frame.m_openPass < MAX_PASSES) {
+        endPass();
+    }
+    glQueryCounter(frame.m_queries[1], GL_TIMESTAMP);
+    frame.m_cpuEnd = Profiler::now();
+    frame.m_pending = true;
+}
+
+void GpuTimer::beginPass(const char* name) {
+    Frame& frame = m_frames[m_currentFrame];
+    if (frame.m_passCount == MAX_PASSES) {
+        return;
+    }
+    Pass& pass = frame.m_passes[frame.m_passCount];
+    pass.m_name = name;
+    pass.m_cpuBegin = Profiler::now();
+    glQueryCounter(pass.m_queries[0], GL_TIMESTAMP);
+    frame.m_openPass = frame.m_passCount;
+}
+
+void GpuTimer::endPass() {
+    Frame& frame = m_frames[m_currentFrame];
+    if (frame.m_openPass >= MAX_PASSES) {
+        return;
+    }
+    Pass& pass = frame.m_passes[frame.m_openPass];
+    glQueryCounter(pass.m_queries[1], GL_TIMESTAMP);
+    pass.m_cpuEnd = Profiler::now();
+    frame.m_passCount++;
+    frame.m_openPass = MAX_PASSES;
+}
+
+std::uint64_t GpuTimer::getCollectedCount() const {
+    return m_collectedCount;
+}
+
+std::uint64_t GpuTimer::getDroppedCount() const {
+    return m_droppedCount;
+}
+
+double GpuTimer::getLastFrameTime() const {
+    return m_lastGpuFrameTime;
+}
+
+double GpuTimer::getLastPassTime(const char* name) const {
+    for (const PassStats& stats : m_passStats) {
+        if (std::strcmp(stats.m_name, name) == 0) {
+            return stats.m_lastGpuTime;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,93 @@
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// keep this before all other OpenGL libraries
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+#include "core/looplog.h"
+
+/// A companion to `FrameTimer` that measures how long the GPU spends on
+/// each frame and on named passes within it, next to the CPU time spent
+/// submitting them. Every frame and pass is bracketed by `GL_TIMESTAMP`
+/// queries. The queries of the last few frames are kept in a ring and
+/// are only read once the driver reports them as available, so reading
+/// results never stalls the pipeline; frames whose results are still not
+/// available when their slot is reused are dropped. About once a second
+/// the averages are added to the `LoopLog` buffer.
+class GpuTimer {
+private:
+    static constexpr unsigned int FRAME_LATENCY = 4;
+    static constexpr unsigned int MAX_PASSES = 16;
+
+    struct Pass {
+        const char* m_name;
+        GLuint m_queries[2];
+        std::uint64_t m_cpuBegin, m_cpuEnd;
+    };
+
+    struct Frame {
+        GLuint m_queries[2];
+        std::uint64_t m_cpuBegin, m_cpuEnd;
+        std::array<Pass, MAX_PASSES> m_passes;
+        unsigned int m_passCount;
+        unsigned int m_openPass;
+        bool m_pending;
+    };
+
+    struct PassStats {
+        const char* m_name;
+        double m_gpuTime, m_cpuTime;
+        unsigned long m_samples;
+        /// GPU time of the pass in the last frame read.
+        double m_lastGpuTime;
+    };
+
+    std::array<Frame, FRAME_LATENCY> m_frames;
+    unsigned int m_currentFrame;
+    std::vector<PassStats> m_passStats;
+    double m_gpuFrameTime, m_cpuFrameTime;
+    unsigned long m_frameSamples, m_droppedFrames;
+    std::uint64_t m_collectedCount, m_droppedCount;
+    double m_lastGpuFrameTime;
+    std::uint64_t m_previousUpdate;
+    LoopLog* m_loopLog;
+
+    /// Reads the results of a finished frame if they are available.
+    /// @return True if the frame's results were read.
+    bool collectFrame(Frame& frame);
+    void report();
+public:
+    GpuTimer();
+    void releaseQueries();
+
+    /// Starts timing a frame, should be called once at the start of the
+    /// render loop.
+    void beginFrame();
+    /// Stops timing the frame, should be called after the last draw call
+    /// of the frame and before swapping buffers.
+    void endFrame();
+    /// Starts timing a pass within the frame. Passes may not overlap.
+    /// @param name Name of the pass, must outlive the timer, such as a
+    /// string literal.
+    void beginPass(const char* name);
+    void endPass();
+
+    /// @return Number of frames whose results have been read since the
+    /// timer was created.
+    std::uint64_t getCollectedCount() const;
+    /// @return Number of frames dropped since the timer was created.
+    std::uint64_t getDroppedCount() const;
+    /// @return GPU time in seconds of the last frame whose results were
+    /// read.
+    double getLastFrameTime() const;
+    /// @return GPU time in seconds of the named pass in the last frame
+    /// read that had it, negative if no results of the pass were read.
+    double getLastPassTime(const char* name) const;
+};
+
+#endif
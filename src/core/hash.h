@@ -0,0 +1,28 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+/// Hashes a block of memory with 64 bit FNV-1a. This is a checksum and
+/// cache key, not a cryptographic hash.
+/// @param hash Hash to continue from, so several blocks can be hashed
+/// as if they were one.
+inline std::uint64_t fnv1a(const void* data, size_t size, std::uint64_t hash = FNV_OFFSET_BASIS) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+inline std::uint64_t fnv1a(const std::string& text, std::uint64_t hash = FNV_OFFSET_BASIS) {
+    return fnv1a(text.data(), text.size(), hash);
+}
+
+#endif
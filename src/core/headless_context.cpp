@@ -0,0 +1,152 @@
+#include "core/headless_context.h"
+
+#include <cstring>
+#include <iostream>
+#include <EGL/eglext.h>
+
+HeadlessContext::HeadlessContext() {
+    m_display = EGL_NO_DISPLAY;
+    m_context = EGL_NO_CONTEXT;
+    m_framebuffer = 0;
+    m_renderbuffers[0] = m_renderbuffers[1] = 0;
+    m_width = m_height = 0;
+}
+
+/// @return True if `name` is one of the space separated `extensions`.
+static bool hasExtension(const char* extensions, const char* name) {
+    size_t length = std::strlen(name);
+    for (const char* position = extensions; (position != nullptr) && (*position != '\0'); ) {
+        const char* end = std::strchr(position, ' ');
+        size_t size = (end != nullptr) ? static_cast<size_t>(end - position) : std::strlen(position);
+        if ((size == length) && (std::strncmp(position, name, length) == 0)) {
+            return true;
+        }
+        position = (end != nullptr) ? end + 1 : nullptr;
+    }
+    return false;
+}
+
+/// Prefers the Mesa surfaceless platform, which does not need a display
+/// server, and falls back to the default display otherwise. The context
+/// is created without a config where the display supports that, and
+/// otherwise with the first config that renders desktop OpenGL. It asks
+/// for an OpenGL 4.3 core profile, with 3.3 as the fallback, and is made
+/// current without a surface.
+bool HeadlessContext::create(int width, int height) {
+    m_width = width;
+    m_height = height;
+
+#if defined(EGL_EXT_platform_base) && defined(EGL_PLATFORM_SURFACELESS_MESA)
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay != nullptr) {
+        m_display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+#endif
+    if (m_display == EGL_NO_DISPLAY) {
+        m_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    EGLint major, minor;
+    if ((m_display == EGL_NO_DISPLAY) || (eglInitialize(m_display, &major, &minor) != EGL_TRUE)) {
+        std::cerr << "Failed to initalize EGL.\n";
+        return false;
+    }
+
+    if (eglBindAPI(EGL_OPENGL_API) != EGL_TRUE) {
+        std::cerr << "EGL does not support desktop OpenGL.\n";
+        release();
+        return false;
+    }
+
+    const char* extensions = eglQueryString(m_display, EGL_EXTENSIONS);
+    EGLConfig config = EGL_NO_CONFIG_KHR;
+    if (!hasExtension(extensions, "EGL_KHR_no_config_context") && !hasExtension(extensions, "EGL_MESA_configless_context")) {
+        // the default surface type is a window, which a surfaceless display
+        // has no configs for
+        const EGLint config_attributes[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+        EGLint config_count = 0;
+        if ((eglChooseConfig(m_display, config_attributes, &config, 1, &config_count) != EGL_TRUE) || (config_count == 0)) {
+            std::cerr << "No EGL config supports desktop OpenGL.\n";
+            release();
+            return false;
+        }
+    }
+
+    // the context version can only be asked for with EGL 1.5 or
+    // EGL_KHR_create_context, otherwise the driver picks it
+    if ((major > 1) || (minor >= 5) || hasExtension(extensions, "EGL_KHR_create_context")) {
+        const EGLint versions[2][2] = {{4, 3}, {3, 3}};
+        for (const EGLint* version : versions) {
+            const EGLint context_attributes[] = {
+                EGL_CONTEXT_MAJOR_VERSION_KHR, version[0],
+                EGL_CONTEXT_MINOR_VERSION_KHR, version[1],
+                EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+                EGL_NONE};
+            m_context = eglCreateContext(m_display, config, EGL_NO_CONTEXT, context_attributes);
+            if (m_context != EGL_NO_CONTEXT) {
+                break;
+            }
+        }
+    } else {
+        m_context = eglCreateContext(m_display, config, EGL_NO_CONTEXT, nullptr);
+    }
+    if (m_context == EGL_NO_CONTEXT) {
+        std::cerr << "Failed to create EGL context, error 0x" << std::hex << eglGetError() << std::dec << ".\n";
+        release();
+        return false;
+    }
+
+    if (eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context) != EGL_TRUE) {
+        std::cerr << "Failed to make the EGL context current.\n";
+        release();
+        return false;
+    }
+    return true;
+}
+
+bool HeadlessContext::createFramebuffer() {
+    glGenRenderbuffers(2, m_renderbuffers);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_renderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_width, m_height);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_renderbuffers[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_width, m_height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_renderbuffers[0]);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_renderbuffers[1]);
+    glViewport(0, 0, m_width, m_height);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Offscreen framebuffer is incomplete.\n";
+        return false;
+    }
+    return true;
+}
+
+void HeadlessContext::release() {
+    if (m_context != EGL_NO_CONTEXT) {
+        if (m_framebuffer != 0) {
+            glDeleteFramebuffers(1, &m_framebuffer);
+            glDeleteRenderbuffers(2, m_renderbuffers);
+            m_framebuffer = 0;
+            m_renderbuffers[0] = m_renderbuffers[1] = 0;
+        }
+        eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(m_display, m_context);
+        m_context = EGL_NO_CONTEXT;
+    }
+    if (m_display != EGL_NO_DISPLAY) {
+        eglTerminate(m_display);
+        m_display = EGL_NO_DISPLAY;
+    }
+}
+
+int HeadlessContext::getWidth() const {
+    return m_width;
+}
+
+int HeadlessContext::getHeight() const {
+    return m_height;
+}
@@ -0,0 +1,37 @@
+#ifndef HEADLESS_CONTEXT_H
+#define HEADLESS_CONTEXT_H
+
+// keep this before all other OpenGL libraries
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <EGL/egl.h>
+
+/// An OpenGL context without a window for running on servers and in CI.
+/// The context is created on an EGL surfaceless display, so it needs no
+/// X11 or Wayland connection and works with Mesa's software rasterizer.
+/// There is no default framebuffer, instead rendering goes to an
+/// offscreen framebuffer object of a fixed size.
+class HeadlessContext {
+private:
+    EGLDisplay m_display;
+    EGLContext m_context;
+    GLuint m_framebuffer;
+    GLuint m_renderbuffers[2];
+    int m_width, m_height;
+public:
+    HeadlessContext();
+
+    /// Creates the context and makes it current on the calling thread.
+    /// @return True if the context was created.
+    bool create(int width, int height);
+    /// Creates and binds the offscreen framebuffer, should be called
+    /// once the OpenGL functions have been loaded.
+    /// @return True if the framebuffer is complete.
+    bool createFramebuffer();
+    void release();
+
+    int getWidth() const;
+    int getHeight() const;
+};
+
+#endif
@@ -0,0 +1,163 @@
+#include "core/indirect_renderer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "core/render_stats.h"
+
+static GLsizeiptr storageAlignment() {
+    GLint alignment = 256;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    return alignment;
+}
+
+static GLsizeiptr alignUp(GLsizeiptr size, GLsizeiptr alignment) {
+    return (size + alignment - 1)/alignment*alignment;
+}
+
+bool IndirectRenderer::isSupported() {
+    return GLEW_ARB_multi_draw_indirect && GLEW_ARB_shader_storage_buffer_object && GLEW_ARB_shader_draw_parameters;
+}
+
+/// Every group starts its transforms at an aligned offset, so the
+/// transform region has room for the padding of `maxGroups` groups and
+/// is itself a multiple of the alignment so every region starts aligned.
+IndirectRenderer::IndirectRenderer(size_t maxDraws, size_t maxGroups) :
+    m_maxDraws(maxDraws),
+    m_transformAlignment(storageAlignment()),
+    m_commandBuffer(GL_DRAW_INDIRECT_BUFFER, static_cast<GLsizeiptr>(maxDraws*sizeof(DrawElementsIndirectCommand))),
+    m_transformBuffer(GL_SHADER_STORAGE_BUFFER, alignUp(static_cast<GLsizeiptr>(maxDraws*sizeof(glm::mat4)), m_transformAlignment) + static_cast<GLsizeiptr>(maxGroups)*m_transformAlignment) {
+    m_overflowed = false;
+}
+
+void IndirectRenderer::releaseBuffers() {
+    m_commandBuffer.releaseBuffers();
+    m_transformBuffer.releaseBuffers();
+}
+
+void IndirectRenderer::submit(GLuint program, const Model& model, const glm::mat4& modelSpaceToWorldSpace) {
+    GLenum index_type = (model.m_indexCount > 0) ? model.m_indexType : 0;
+    // there are only a few groups, one per program and vertex array
+    std::vector<Group>::iterator group = std::find_if(m_groups.begin(), m_groups.end(), [&](const Group& candidate) {
+        return (candidate.m_program == program) && (candidate.m_vertexArray == model.m_vertexArray) && (candidate.m_indexType == index_type);
+    });
+    if (group == m_groups.end()) {
+        m_groups.push_back(Group{program, model.m_vertexArray, index_type, {}, {}});
+        group = m_groups.end() - 1;
+    }
+
+    DrawElementsIndirectCommand command;
+    if (index_type != 0) {
+        command.m_count = static_cast<GLuint>(model.m_indexCount);
+        command.m_firstIndex = model.m_firstIndex;
+        command.m_baseVertex = model.m_baseVertex;
+    } else {
+        command.m_count = static_cast<GLuint>(model.m_vertexCount);
+        command.m_firstIndex = static_cast<GLuint>(model.m_baseVertex);
+        command.m_baseVertex = 0;
+    }
+    command.m_instanceCount = 1;
+    command.m_baseInstance = 0;
+    group->m_commands.push_back(command);
+    group->m_transforms.push_back(modelSpaceToWorldSpace);
+}
+
+void IndirectRenderer::draw() {
+    // groups of programs that were not used this frame, for example
+    // after a shader reload, are dropped
+    m_groups.erase(std::remove_if(m_groups.begin(), m_groups.end(), [](const Group& group) {
+        return group.m_commands.empty();
+    }), m_groups.end());
+    if (m_groups.empty()) {
+        return;
+    }
+
+    // write the commands and transforms of every group, each group's
+    // transforms start at an aligned offset so they can be bound on
+    // their own and indexed from 0 by gl_DrawIDARB
+    unsigned char* commands = static_cast<unsigned char*>(m_commandBuffer.beginWrite());
+    unsigned char* transforms = static_cast<unsigned char*>(m_transformBuffer.beginWrite());
+    std::vector<GLintptr> command_offsets(m_groups.size());
+    std::vector<GLintptr> transform_offsets(m_groups.size());
+    std::vector<GLsizei> draw_counts(m_groups.size());
+    GLintptr command_offset = 0;
+    GLintptr transform_offset = 0;
+    size_t num_draws = 0;
+    for (size_t i = 0; i < m_groups.size(); i++) {
+        Group& group = m_groups[i];
+        transform_offset = alignUp(transform_offset, m_transformAlignment);
+        GLsizeiptr transform_bytes = std::max<GLsizeiptr>(m_transformBuffer.getRegionSize() - transform_offset, 0);
+        size_t transform_room = static_cast<size_t>(transform_bytes)/sizeof(glm::mat4);
+        size_t count = std::min(group.m_commands.size(), std::min(m_maxDraws - num_draws, transform_room));
+        if ((count < group.m_commands.size()) && !m_overflowed) {
+            std::cerr << "Out of indirect draws, increase the number of draws per frame.\n";
+            m_overflowed = true;
+        }
+
+        command_offsets[i] = command_offset;
+        transform_offsets[i] = transform_offset;
+        draw_counts[i] = static_cast<GLsizei>(count);
+        if (group.m_indexType != 0) {
+            std::memcpy(commands + command_offset, group.m_commands.data(), count*sizeof(DrawElementsIndirectCommand));
+            command_offset += static_cast<GLintptr>(count*sizeof(DrawElementsIndirectCommand));
+        } else {
+            for (size_t j = 0; j < count; j++) {
+                const DrawElementsIndirectCommand& command = group.m_commands[j];
+                DrawArraysIndirectCommand arrays_command = {command.m_count, command.m_instanceCount, command.m_firstIndex, command.m_baseInstance};
+                std::memcpy(commands + command_offset, &arrays_command, sizeof(arrays_command));
+                command_offset += static_cast<GLintptr>(sizeof(arrays_command));
+            }
+        }
+        std::memcpy(transforms + transform_offset, group.m_transforms.data(), count*sizeof(glm::mat4));
+        transform_offset += static_cast<GLintptr>(count*sizeof(glm::mat4));
+        num_draws += count;
+    }
+    m_commandBuffer.endWrite(0, command_offset);
+    m_transformBuffer.endWrite(0, transform_offset);
+
+    RenderStats* stats = RenderStats::getInstance();
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer.getBuffer());
+    stats->m_bindCalls++;
+    GLuint program = 0;
+    GLuint vertex_array = 0;
+    for (size_t i = 0; i < m_groups.size(); i++) {
+        Group& group = m_groups[i];
+        if (draw_counts[i] > 0) {
+            if (group.m_program != program) {
+                glUseProgram(group.m_program);
+                program = group.m_program;
+                stats->m_bindCalls++;
+            } else {
+                stats->m_redundantBinds++;
+            }
+            if (group.m_vertexArray != vertex_array) {
+                glBindVertexArray(group.m_vertexArray);
+                vertex_array = group.m_vertexArray;
+                stats->m_bindCalls++;
+            } else {
+                stats->m_redundantBinds++;
+            }
+            glBindBufferRange(GL_SHADER_STORAGE_BUFFER, TRANSFORM_BINDING, m_transformBuffer.getBuffer(),
+                              m_transformBuffer.getRegionOffset() + transform_offsets[i],
+                              static_cast<GLsizeiptr>(static_cast<size_t>(draw_counts[i])*sizeof(glm::mat4)));
+            stats->m_bindCalls++;
+
+            const void* indirect = reinterpret_cast<const void*>(m_commandBuffer.getRegionOffset() + command_offsets[i]);
+            if (group.m_indexType != 0) {
+                glMultiDrawElementsIndirect(GL_TRIANGLES, group.m_indexType, indirect, draw_counts[i], 0);
+            } else {
+                glMultiDrawArraysIndirect(GL_TRIANGLES, indirect, draw_counts[i], 0);
+            }
+            stats->m_drawCalls++;
+            for (GLsizei j = 0; j < draw_counts[i]; j++) {
+                stats->m_triangles += group.m_commands[static_cast<size_t>(j)].m_count/3;
+            }
+        }
+        group.m_commands.clear();
+        group.m_transforms.clear();
+    }
+
+    m_commandBuffer.lockRegion();
+    m_transformBuffer.lockRegion();
+}
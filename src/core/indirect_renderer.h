@@ -0,0 +1,83 @@
+#ifndef INDIRECT_RENDERER_H
+#define INDIRECT_RENDERER_H
+
+#include <vector>
+
+// keep this before all other OpenGL libraries
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "core/model.h"
+#include "core/stream_buffer.h"
+
+/// The command layout read by `glMultiDrawElementsIndirect`.
+struct DrawElementsIndirectCommand {
+    GLuint m_count;
+    GLuint m_instanceCount;
+    GLuint m_firstIndex;
+    GLint m_baseVertex;
+    GLuint m_baseInstance;
+};
+
+/// The command layout read by `glMultiDrawArraysIndirect`.
+struct DrawArraysIndirectCommand {
+    GLuint m_count;
+    GLuint m_instanceCount;
+    GLuint m_first;
+    GLuint m_baseInstance;
+};
+
+/// A renderer that draws every model sharing a program and vertex array
+/// with one multi draw indirect call, so the number of calls depends on
+/// the number of programs and vertex arrays instead of the number of
+/// objects. Models allocated from a `GeometryPool` all share one vertex
+/// array.
+///
+/// The draw commands of a frame are written to a stream buffer of
+/// indirect commands and the transforms to a stream buffer bound as the
+/// `TransformBlock` shader storage block, where the vertex shader reads
+/// the transform of its draw with `gl_DrawIDARB`. This needs
+/// `ARB_multi_draw_indirect`, `ARB_shader_storage_buffer_object` and
+/// `ARB_shader_draw_parameters`, see `isSupported()`.
+class IndirectRenderer {
+public:
+    /// Shader storage binding of the `TransformBlock` block.
+    static constexpr GLuint TRANSFORM_BINDING = 0;
+private:
+    /// Draws that are issued with one call.
+    struct Group {
+        GLuint m_program;
+        GLuint m_vertexArray;
+        /// Index type of the models, 0 for models without indices.
+        GLenum m_indexType;
+        std::vector<DrawElementsIndirectCommand> m_commands;
+        std::vector<glm::mat4> m_transforms;
+    };
+
+    std::vector<Group> m_groups;
+    size_t m_maxDraws;
+    GLsizeiptr m_transformAlignment;
+    StreamBuffer m_commandBuffer;
+    StreamBuffer m_transformBuffer;
+    bool m_overflowed;
+public:
+    /// @return True if the driver has the extensions the renderer needs.
+    static bool isSupported();
+
+    /// @param maxDraws Number of draws each frame has room for.
+    /// @param maxGroups Number of program and vertex array pairs each
+    /// frame has room for.
+    IndirectRenderer(size_t maxDraws=4096, size_t maxGroups=16);
+    void releaseBuffers();
+
+    /// Adds a draw to the current frame.
+    /// @param program Program the model is drawn with, its vertex shader
+    /// should read the transform from `TransformBlock`.
+    void submit(GLuint program, const Model& model, const glm::mat4& modelSpaceToWorldSpace);
+    /// Draws everything submitted since the last call to `draw()` and
+    /// fences the regions of the frame.
+    void draw();
+};
+
+#endif
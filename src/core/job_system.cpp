@@ -0,0 +1,124 @@
+#include "core/job_system.h"
+
+JobSystem::JobSystem(unsigned threadCount) : m_queuedJobs(0), m_running(true), m_deterministic(false) {
+    // the calling thread gets the last queue so it can steal like the workers
+    for (unsigned i = 0; i < threadCount + 1; i++) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (unsigned i = 0; i < threadCount; i++) {
+        m_threads.emplace_back(&JobSystem::workerLoop, this, static_cast<size_t>(i));
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_running = false;
+    }
+    m_wake.notify_all();
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+}
+
+bool JobSystem::findJob(size_t workerIndex, Job& job) {
+    {
+        Worker& worker = *m_workers[workerIndex];
+        std::lock_guard<std::mutex> lock(worker.m_mutex);
+        if (!worker.m_jobs.empty()) {
+            job = worker.m_jobs.back();
+            worker.m_jobs.pop_back();
+            m_queuedJobs--;
+            return true;
+        }
+    }
+
+    for (size_t offset = 1; offset < m_workers.size(); offset++) {
+        Worker& victim = *m_workers[(workerIndex + offset) % m_workers.size()];
+        std::lock_guard<std::mutex> lock(victim.m_mutex);
+        if (!victim.m_jobs.empty()) {
+            job = victim.m_jobs.front();
+            victim.m_jobs.pop_front();
+            m_queuedJobs--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::runJob(const Job& job) {
+    (*job.m_task)(job.m_begin, job.m_end);
+    job.m_remaining->fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::workerLoop(size_t workerIndex) {
+    Job job;
+    while (true) {
+        if (findJob(workerIndex, job)) {
+            runJob(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.wait(lock, [this]() { return !m_running || m_queuedJobs > 0; });
+        if (!m_running) {
+            return;
+        }
+    }
+}
+
+void JobSystem::parallelFor(size_t count, size_t chunkSize, const Task& task) {
+    if (count == 0) {
+        return;
+    }
+    if (chunkSize == 0) {
+        chunkSize = 1;
+    }
+
+    // small loops and deterministic mode stay on the calling thread
+    if (m_deterministic || m_threads.empty() || count <= chunkSize) {
+        for (size_t begin = 0; begin < count; begin += chunkSize) {
+            task(begin, std::min(begin + chunkSize, count));
+        }
+        return;
+    }
+
+    size_t num_chunks = (count + chunkSize - 1)/chunkSize;
+    std::atomic<size_t> remaining(num_chunks);
+    for (size_t chunk = 0; chunk < num_chunks; chunk++) {
+        size_t begin = chunk*chunkSize;
+        Worker& worker = *m_workers[chunk % m_workers.size()];
+        std::lock_guard<std::mutex> lock(worker.m_mutex);
+        worker.m_jobs.push_back(Job{&task, begin, std::min(begin + chunkSize, count), &remaining});
+        m_queuedJobs++;
+    }
+    {
+        // taking the lock avoids a lost wake up between a worker's
+        // check of m_queuedJobs and it going to sleep
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+    }
+    m_wake.notify_all();
+
+    // help out until all chunks, including stolen ones, are finished
+    size_t caller_index = m_workers.size() - 1;
+    Job job;
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        if (findJob(caller_index, job)) {
+            runJob(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::setDeterministic(bool deterministic) {
+    m_deterministic = deterministic;
+}
+
+bool JobSystem::isDeterministic() const {
+    return m_deterministic;
+}
+
+unsigned JobSystem::threadCount() const {
+    return static_cast<unsigned>(m_threads.size());
+}
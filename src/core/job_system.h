@@ -0,0 +1,72 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// A pool of worker threads for splitting loops over many independent
+/// elements, such as object updates, into parallel chunks. Every worker
+/// owns a queue of chunks and idle workers steal chunks from the other
+/// queues. The calling thread helps with the work and `parallelFor()`
+/// only returns once every chunk is done, so the caller can keep sole
+/// ownership of the OpenGL context.
+///
+/// In deterministic mode the chunks are run in order on the calling
+/// thread, which reproduces the sequential path exactly.
+class JobSystem {
+public:
+    using Task = std::function<void(size_t begin, size_t end)>;
+private:
+    struct Job {
+        const Task* m_task;
+        size_t m_begin, m_end;
+        std::atomic<size_t>* m_remaining;
+    };
+
+    struct Worker {
+        std::mutex m_mutex;
+        std::deque<Job> m_jobs;
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::atomic<size_t> m_queuedJobs;
+    std::atomic<bool> m_running;
+    bool m_deterministic;
+
+    /// Pops a job from the back of the worker's own queue or steals one
+    /// from the front of another worker's queue.
+    /// @return True if a job was found.
+    bool findJob(size_t workerIndex, Job& job);
+    void runJob(const Job& job);
+    void workerLoop(size_t workerIndex);
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+public:
+    /// @param threadCount Number of worker threads in addition to the
+    /// calling thread. Defaults to one less than the number of cores.
+    explicit JobSystem(unsigned threadCount = std::max(std::thread::hardware_concurrency(), 1u) - 1);
+    ~JobSystem();
+
+    /// Calls `task` on consecutive ranges of [0, count) of at most
+    /// `chunkSize` elements and waits until all ranges are done. Ranges
+    /// may run concurrently so `task` must only touch its own elements.
+    void parallelFor(size_t count, size_t chunkSize, const Task& task);
+
+    void setDeterministic(bool deterministic);
+    bool isDeterministic() const;
+    /// @return Number of worker threads, not counting the calling thread.
+    unsigned threadCount() const;
+};
+
+#endif
@@ -0,0 +1,30 @@
+#include "core/lod.h"
+
+void LodChain::addLevel(ModelHandle model, float minScreenSize) {
+    m_levels.push_back(model);
+    m_minScreenSizes.push_back(minScreenSize);
+}
+
+/// Starts from the current level and moves one level at a time, so a
+/// sudden change in size still ends on the right level.
+size_t LodChain::selectLevel(float screenSize, size_t currentLevel) const {
+    if (m_levels.empty()) {
+        return 0;
+    }
+    size_t level = (currentLevel < m_levels.size()) ? currentLevel : m_levels.size() - 1;
+    while ((level > 0) && (screenSize > (1.f + m_hysteresis)*m_minScreenSizes[level - 1])) {
+        level--;
+    }
+    while ((level + 1 < m_levels.size()) && (screenSize < (1.f - m_hysteresis)*m_minScreenSizes[level])) {
+        level++;
+    }
+    return level;
+}
+
+size_t LodChain::size() const {
+    return m_levels.size();
+}
+
+ModelHandle LodChain::getLevel(size_t level) const {
+    return m_levels[level];
+}
@@ -0,0 +1,41 @@
+#ifndef LOD_H
+#define LOD_H
+
+#include <vector>
+
+#include "core/model.h"
+
+/// A chain of models of the same object at decreasing levels of detail,
+/// held as handles into a `ModelRegistry`. Level 0 is the most detailed.
+/// Each level has the smallest screen size it is used for, as a fraction
+/// of the viewport height covered by the object, and the last level is
+/// used for anything smaller.
+///
+/// To avoid popping when an object sits near a threshold, `selectLevel()`
+/// only moves to a more detailed level once the screen size is
+/// `m_hysteresis` above that level's threshold, and to a less detailed
+/// level once it is `m_hysteresis` below the current level's threshold.
+class LodChain {
+private:
+    std::vector<ModelHandle> m_levels;
+    std::vector<float> m_minScreenSizes;
+public:
+    /// Relative margin around each threshold.
+    float m_hysteresis = 0.15f;
+
+    /// Adds a level less detailed than all the levels added so far.
+    /// @param minScreenSize Smallest screen size the level is used for,
+    /// should be less than that of the previous level.
+    void addLevel(ModelHandle model, float minScreenSize);
+
+    /// @param screenSize Fraction of the viewport height covered by the
+    /// object.
+    /// @param currentLevel Level the object used last frame.
+    /// @return Level the object should use this frame.
+    size_t selectLevel(float screenSize, size_t currentLevel) const;
+    /// @return Number of levels in the chain.
+    size_t size() const;
+    ModelHandle getLevel(size_t level) const;
+};
+
+#endif
@@ -1,36 +1,194 @@
 #include "core/looplog.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
-LoopLog* LoopLog::m_instance = nullptr;
+void LogRing::write(const char* text, size_t length) {
+    if (m_write + length - m_cachedRead > CAPACITY) {
+        m_cachedRead = m_read.load(std::memory_order_acquire);
+        if (m_write + length - m_cachedRead > CAPACITY) {
+            m_dropped.store(m_dropped.load(std::memory_order_relaxed) + length, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    size_t offset = static_cast<size_t>(m_write % CAPACITY);
+    size_t first = std::min(length, static_cast<size_t>(CAPACITY) - offset);
+    std::memcpy(m_buffer.data() + offset, text, first);
+    std::memcpy(m_buffer.data(), text + first, length - first);
+    m_write += length;
+    m_committed.store(m_write, std::memory_order_release);
+}
+
+void LogStream::write(const char* text, size_t length) {
+    LogRing* ring = LoopLog::getInstance()->threadRing();
+    if (ring != nullptr) {
+        ring->write(text, length);
+    }
+}
+
+LogStream& LogStream::operator<<(const char* text) {
+    write(text, std::strlen(text));
+    return *this;
+}
+
+LogStream& LogStream::operator<<(const std::string& text) {
+    write(text.data(), text.size());
+    return *this;
+}
+
+LogStream& LogStream::operator<<(char character) {
+    write(&character, 1);
+    return *this;
+}
+
+LogStream& LogStream::operator<<(double value) {
+    char buffer[32];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 6);
+    write(buffer, static_cast<size_t>(result.ptr - buffer));
+    return *this;
+}
+
+LogStream& LogStream::operator<<(float value) {
+    return *this << static_cast<double>(value);
+}
 
 LoopLog::LoopLog() {
+    for (std::atomic<LogRing*>& ring : m_rings) {
+        ring = nullptr;
+    }
+    m_ringCount = 0;
+    m_frameSequence = 0;
+    for (size_t i = 0; i < MAX_THREADS; i++) {
+        m_frameEnd[i] = 0;
+    }
+    m_flushedEnd.fill(0);
+    m_printedSequence = 0;
+    m_reportedDropped.fill(0);
+    m_printedLines = 0;
+    m_running = true;
+    m_writer = std::thread(&LoopLog::writerLoop, this);
 }
 
-/// Moves the cursor back to where it was prior to flushing the log.
-void LoopLog::resetCursor() {
-    std::string buffer = m_log.str();
-    for (char &c : buffer) {
-        if (c == '\n') {
-            std::cout << "\033[A";
+/// The instance is created by a function local static, since any thread
+/// may be the first to log.
+LoopLog* LoopLog::getInstance() {
+    static LoopLog* instance = new LoopLog();
+    return instance;
+}
+
+LogRing* LoopLog::threadRing() {
+    // every thread takes an index once, threads past MAX_THREADS remember
+    // that they have no ring instead of taking a new index on every call,
+    // which would eventually wrap around onto the rings in use
+    thread_local bool has_index = false;
+    thread_local LogRing* ring = nullptr;
+    if (!has_index) {
+        has_index = true;
+        std::uint32_t index = m_ringCount.fetch_add(1);
+        if (index < MAX_THREADS) {
+            // rings are never freed so the writer can still read them
+            // after their thread has exited
+            ring = new LogRing();
+            m_rings[index].store(ring, std::memory_order_release);
         }
     }
+    return ring;
 }
 
-LoopLog* LoopLog::getInstance() {
-    if (m_instance == nullptr) {
-        m_instance = new LoopLog();
+void LoopLog::flush() {
+    std::array<std::uint64_t, MAX_THREADS> end;
+    bool changed = false;
+    for (size_t i = 0; i < MAX_THREADS; i++) {
+        LogRing* ring = m_rings[i].load(std::memory_order_acquire);
+        end[i] = (ring != nullptr) ? ring->m_committed.load(std::memory_order_acquire) : 0;
+        changed = changed || (end[i] != m_flushedEnd[i]);
+    }
+    if (!changed) {
+        return;
+    }
+
+    std::uint64_t sequence = m_frameSequence.load(std::memory_order_relaxed);
+    m_frameSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < MAX_THREADS; i++) {
+        m_frameEnd[i].store(end[i], std::memory_order_relaxed);
+    }
+    m_frameSequence.store(sequence + 2, std::memory_order_release);
+    m_flushedEnd = end;
+}
+
+void LoopLog::writerLoop() {
+    while (m_running.load(std::memory_order_acquire)) {
+        std::this_thread::sleep_for(PRINT_INTERVAL);
+        printFrame(false);
+    }
+    printFrame(true);
+}
+
+/// Reads the end of the flushed text, retrying while it is being
+/// published, and prints everything from the end of the previously
+/// printed text up to it.
+void LoopLog::printFrame(bool last) {
+    std::array<std::uint64_t, MAX_THREADS> end;
+    std::uint64_t sequence;
+    while (true) {
+        sequence = m_frameSequence.load(std::memory_order_acquire);
+        for (size_t i = 0; i < MAX_THREADS; i++) {
+            end[i] = m_frameEnd[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (((sequence & 1) == 0) && (sequence == m_frameSequence.load(std::memory_order_relaxed))) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+
+    if (sequence == m_printedSequence) {
+        // move below the text that is already on screen
+        if (last) {
+            for (size_t line = 0; line < m_printedLines; line++) {
+                std::cout << "\033[B";
+            }
+            std::cout.flush();
+        }
+        return;
+    }
+    m_printedSequence = sequence;
+
+    m_output.clear();
+    for (size_t i = 0; i < MAX_THREADS; i++) {
+        LogRing* ring = m_rings[i].load(std::memory_order_acquire);
+        if (ring == nullptr) {
+            continue;
+        }
+        std::uint64_t begin = ring->m_read.load(std::memory_order_relaxed);
+        for (std::uint64_t position = begin; position < end[i]; position++) {
+            m_output.push_back(ring->m_buffer[static_cast<size_t>(position % LogRing::CAPACITY)]);
+        }
+        ring->m_read.store(end[i], std::memory_order_release);
+
+        std::uint64_t dropped = ring->m_dropped.load(std::memory_order_relaxed);
+        if (dropped != m_reportedDropped[i]) {
+            m_output += "LoopLog dropped " + std::to_string(dropped - m_reportedDropped[i]) + " bytes\n";
+            m_reportedDropped[i] = dropped;
+        }
+    }
+
+    std::cout << m_output;
+    m_printedLines = static_cast<size_t>(std::count(m_output.begin(), m_output.end(), '\n'));
+    if (!last) {
+        for (size_t line = 0; line < m_printedLines; line++) {
+            std::cout << "\033[A";
+        }
     }
-    return m_instance;
+    std::cout.flush();
 }
 
-void LoopLog::flush(){
-    std::string buffer = m_log.str();
-    if (buffer != "") {
-        std::cout << buffer;
-        resetCursor();
-        std::cout.flush();
+void LoopLog::close() {
+    m_running.store(false, std::memory_order_release);
+    if (m_writer.joinable()) {
+        m_writer.join();
     }
-    m_log.str("");
-    m_log.clear();
 }
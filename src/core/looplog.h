@@ -1,36 +1,119 @@
 #ifndef LOOPLOG_H
 #define LOOPLOG_H
 
-#include <sstream>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+/// A fixed size single producer, single consumer queue of log text.
+/// Positions count bytes since the ring was created and wrap around the
+/// buffer, the producer never overwrites text the writer has not read.
+struct LogRing {
+    static constexpr std::uint64_t CAPACITY = 1 << 14;
+
+    std::array<char, CAPACITY> m_buffer;
+    /// Only used by the producer.
+    std::uint64_t m_write = 0, m_cachedRead = 0;
+    alignas(64) std::atomic<std::uint64_t> m_committed{0};
+    alignas(64) std::atomic<std::uint64_t> m_read{0};
+    std::atomic<std::uint64_t> m_dropped{0};
+
+    /// Appends text to the ring, text that does not fit is dropped.
+    void write(const char* text, size_t length);
+};
+
+/// The stream like front end of `LoopLog`. Strings and numbers are
+/// formatted on the stack and appended to the calling thread's ring, so
+/// logging never allocates or takes a lock.
+class LogStream {
+private:
+    static void write(const char* text, size_t length);
+public:
+    LogStream& operator<<(const char* text);
+    LogStream& operator<<(const std::string& text);
+    LogStream& operator<<(char character);
+    /// Formats like `std::ostream` with the default precision of 6.
+    LogStream& operator<<(double value);
+    LogStream& operator<<(float value);
+
+    template<typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+    LogStream& operator<<(Integer value) {
+        char buffer[24];
+        std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        write(buffer, static_cast<size_t>(result.ptr - buffer));
+        return *this;
+    }
+};
 
 /// A class for convienient logging in a render loop.
-/// Text added to `instance.log` during the render loop will be printed
-/// to the standard output device when `instance.flush()` is called. The
+/// Text added to `instance.m_log` during the render loop will be printed
+/// to the standard output device after `instance.flush()` is called. The
 /// intention is that any functions called during the render loop can
 /// log info in a live update instead of a stream of text flowing by.
 /// LoopLog should only be flushed once per render iteration.
+///
+/// Each thread logs to its own ring and `flush()` only marks the text
+/// logged so far as finished. A writer thread prints the finished text
+/// at most once every `PRINT_INTERVAL`, the text of all frames flushed
+/// in between is printed together, so the render loop never waits on
+/// the terminal.
 class LoopLog {
 private:
-    static LoopLog* m_instance;
+    static constexpr size_t MAX_THREADS = 64;
+    static constexpr std::chrono::milliseconds PRINT_INTERVAL{33};
+
+    std::array<std::atomic<LogRing*>, MAX_THREADS> m_rings;
+    std::atomic<std::uint32_t> m_ringCount;
+
+    // end of the flushed text in each ring, published with a sequence lock
+    std::atomic<std::uint64_t> m_frameSequence;
+    std::array<std::atomic<std::uint64_t>, MAX_THREADS> m_frameEnd;
+    /// Only used by the flushing thread.
+    std::array<std::uint64_t, MAX_THREADS> m_flushedEnd;
+
+    /// Only used by the writer thread.
+    std::uint64_t m_printedSequence;
+    std::array<std::uint64_t, MAX_THREADS> m_reportedDropped;
+    size_t m_printedLines;
+    std::string m_output;
+
+    std::atomic<bool> m_running;
+    std::thread m_writer;
 
     LoopLog();
 
-    /// Returns the cursor to where it was before the buffer was flushed
-    /// to the standard output.
-    void resetCursor();
+    void writerLoop();
+    /// Prints the text flushed since the previous call, if there is any.
+    /// @param last If false the cursor is returned to where it was
+    /// before printing, so the next text is printed over this one.
+    void printFrame(bool last);
 
     LoopLog(const LoopLog&) = delete;
     LoopLog& operator=(const LoopLog&) = delete;
 public:
-    std::stringstream m_log;
+    LogStream m_log;
 
     /// Gets and instance of the LoogLoop singleton.
     /// @return Pointer to an instance of LoogLoop.
     static LoopLog* getInstance();
 
-    /// Writes the log buffer to the standard output. This function should
-    /// only be called once in the render loop.
+    /// @return The ring of the calling thread, created on first use. Null
+    /// for threads beyond the first `MAX_THREADS`, whose text is dropped.
+    LogRing* threadRing();
+    /// Marks the text logged since the last call as a finished frame to
+    /// be printed. This function should only be called once in the
+    /// render loop.
     void flush();
+    /// Prints the last flushed frame, leaving the cursor below it, and
+    /// stops the writer thread. Should be called once the render loop
+    /// has finished, before anything else is written to the standard
+    /// output.
+    void close();
 };
 
 #endif
@@ -0,0 +1,62 @@
+#include "core/mesh.h"
+
+GLsizei Mesh::vertexBufferSize() const {
+    return m_vertexCount*Format::stride;
+}
+
+GLsizei Mesh::indexBufferSize() const {
+    size_t index_size = (m_indexType == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint);
+    return static_cast<GLsizei>(static_cast<size_t>(m_indexCount)*index_size);
+}
+
+/// A grid with a single point along an axis has it at 0 instead of
+/// dividing by zero.
+glm::vec2 gridPoint(int x_resolution, int y_resolution, int row_index, int column_index) {
+    glm::vec2 unit_pos = glm::vec2(0.f, 0.f);
+    if (x_resolution > 1) {
+        unit_pos.x = static_cast<float>(row_index)/static_cast<float>(x_resolution - 1);
+    }
+    if (y_resolution > 1) {
+        unit_pos.y = static_cast<float>(column_index)/static_cast<float>(y_resolution - 1);
+    }
+    return unit_pos;
+}
+
+/// Writes the indices of the two triangles in each quad. The triangles
+/// use the same vertex order as the original unindexed grid, the lower
+/// left, upper right and then the off diagonal vertex.
+template<typename Index>
+static void writeGridIndices(Index* indices, int x_resolution, int y_resolution) {
+    for (int column_index = 0; column_index < y_resolution - 1; column_index++) {
+        for (int row_index = 0; row_index < x_resolution - 1; row_index++) {
+            Index lower_left = static_cast<Index>(column_index*x_resolution + row_index);
+            Index lower_right = static_cast<Index>(lower_left + 1);
+            Index upper_left = static_cast<Index>(lower_left + x_resolution);
+            Index upper_right = static_cast<Index>(upper_left + 1);
+
+            *indices++ = lower_left;
+            *indices++ = upper_right;
+            *indices++ = lower_right;
+
+            *indices++ = lower_left;
+            *indices++ = upper_right;
+            *indices++ = upper_left;
+        }
+    }
+}
+
+void buildGridIndices(Arena& arena, Mesh& mesh, int x_resolution, int y_resolution) {
+    mesh.m_indexCount = (x_resolution - 1)*(y_resolution - 1)*2*3; // (x_resolution - 1)*(y_resolution - 1) quads, 2 triangles per quad, 3 points per triangle
+
+    if (x_resolution*y_resolution <= 0xFFFF) {
+        mesh.m_indexType = GL_UNSIGNED_SHORT;
+        GLushort* indices = arena.allocate<GLushort>(static_cast<size_t>(mesh.m_indexCount));
+        writeGridIndices(indices, x_resolution, y_resolution);
+        mesh.m_indices = indices;
+    } else {
+        mesh.m_indexType = GL_UNSIGNED_INT;
+        GLuint* indices = arena.allocate<GLuint>(static_cast<size_t>(mesh.m_indexCount));
+        writeGridIndices(indices, x_resolution, y_resolution);
+        mesh.m_indices = indices;
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef MESH_H
+#define MESH_H
+
+// keep this before all other OpenGL libraries
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "core/arena.h"
+#include "core/vertex_format.h"
+
+/// CPU side geometry for an indexed triangle mesh. Each vertex is stored
+/// once in `m_vertices`, interleaved as described by `Format`, and the
+/// triangles reference them through the index buffer. The index type is
+/// `GL_UNSIGNED_SHORT` when every vertex can be addressed with 16 bits
+/// and `GL_UNSIGNED_INT` otherwise. The buffers are staging memory owned
+/// by the `Arena` the mesh was built in and are only valid until that
+/// arena is reset.
+class Mesh {
+public:
+    using Format = PositionColorFormat;
+
+    GLfloat* m_vertices = nullptr;
+    void* m_indices = nullptr;
+    GLenum m_indexType = GL_UNSIGNED_INT;
+    GLsizei m_vertexCount = 0;
+    GLsizei m_indexCount = 0;
+
+    /// @return The size of the vertex buffer in bytes.
+    GLsizei vertexBufferSize() const;
+    /// @return The size of the index buffer in bytes.
+    GLsizei indexBufferSize() const;
+};
+
+/// Gets the position on the unit square of a point in a regular grid.
+/// @param x_resolution Number of grid points along the x axis.
+/// @param y_resolution Number of grid points along the y axis.
+/// @param row_index Index of the grid point along the x axis.
+/// @param column_index Index of the grid point along the y axis.
+/// @return Coordinate of the grid point on the unit square.
+glm::vec2 gridPoint(int x_resolution, int y_resolution, int row_index, int column_index);
+
+/// Allocates the index buffer of `mesh` from `arena` and fills it with
+/// two triangles for every quad of a `x_resolution` by `y_resolution`
+/// grid. Grid points are expected to be stored row by row, so the point
+/// (row_index, column_index) is the vertex
+/// `column_index*x_resolution + row_index`.
+void buildGridIndices(Arena& arena, Mesh& mesh, int x_resolution, int y_resolution);
+
+/// Evaluates a parametric function once per point of a regular grid on
+/// the unit square, storing the points row by row. The function should
+/// have the signature
+/// `void(glm::vec2 unit_pos, glm::vec3& position, glm::vec3& color)`.
+/// @param vertices Destination for the interleaved position and color
+/// of each grid point in the `Mesh::Format` layout.
+template<typename Function>
+void evaluateGrid(int x_resolution, int y_resolution, Function function, GLfloat* vertices) {
+    size_t offset = 0;
+    for (int column_index = 0; column_index < y_resolution; column_index++) {
+        for (int row_index = 0; row_index < x_resolution; row_index++) {
+            glm::vec3 position, color;
+            function(gridPoint(x_resolution, y_resolution, row_index, column_index), position, color);
+
+            for (int i = 0; i < 3; i++) {
+                vertices[offset + static_cast<size_t>(i)] = position[i];
+                vertices[offset + 3 + static_cast<size_t>(i)] = color[i];
+            }
+            offset += 6;
+        }
+    }
+}
+
+/// Builds an indexed mesh over a regular grid on the unit square with
+/// the staging buffers allocated from `arena`. The parametric function
+/// is evaluated once per grid point, see `evaluateGrid()`.
+template<typename Function>
+Mesh buildGridMesh(Arena& arena, int x_resolution, int y_resolution, Function function) {
+    Mesh mesh;
+    mesh.m_vertexCount = x_resolution*y_resolution;
+    mesh.m_vertices = arena.allocate<GLfloat>(6*static_cast<size_t>(mesh.m_vertexCount));
+
+    evaluateGrid(x_resolution, y_resolution, function, mesh.m_vertices);
+    buildGridIndices(arena, mesh, x_resolution, y_resolution);
+    return mesh;
+}
+
+#endif
@@ -0,0 +1,143 @@
+#include "core/mesh_cache.h"
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "core/hash.h"
+
+static std::uint64_t alignOffset(std::uint64_t offset) {
+    return (offset + MESH_CACHE_ALIGNMENT - 1) & ~(MESH_CACHE_ALIGNMENT - 1);
+}
+
+static bool fitsInFile(std::uint64_t offset, std::uint64_t size, size_t file_size) {
+    return (offset <= file_size) && (size <= file_size - offset);
+}
+
+bool writeMeshCache(const std::string& path, const Mesh& mesh, std::uint64_t key) {
+    MeshCacheHeader header;
+    std::memcpy(header.m_magic, MeshCacheHeader::MAGIC, sizeof(header.m_magic));
+    header.m_version = MeshCacheHeader::VERSION;
+    header.m_key = key;
+    header.m_vertexStride = static_cast<std::uint32_t>(Mesh::Format::stride);
+    header.m_indexType = mesh.m_indexType;
+    header.m_vertexCount = static_cast<std::uint32_t>(mesh.m_vertexCount);
+    header.m_indexCount = static_cast<std::uint32_t>(mesh.m_indexCount);
+    header.m_vertexOffset = alignOffset(sizeof(MeshCacheHeader));
+    header.m_vertexSize = static_cast<std::uint64_t>(mesh.vertexBufferSize());
+    header.m_indexOffset = alignOffset(header.m_vertexOffset + header.m_vertexSize);
+    header.m_indexSize = static_cast<std::uint64_t>(mesh.indexBufferSize());
+    header.m_checksum = fnv1a(mesh.m_indices, header.m_indexSize, fnv1a(mesh.m_vertices, header.m_vertexSize));
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+    std::string temporary_path = path + ".tmp";
+    std::ofstream file(temporary_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open '" << temporary_path << "' for writing.\n";
+        return false;
+    }
+
+    const char padding[MESH_CACHE_ALIGNMENT] = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(padding, static_cast<std::streamsize>(header.m_vertexOffset - sizeof(header)));
+    file.write(reinterpret_cast<const char*>(mesh.m_vertices), static_cast<std::streamsize>(header.m_vertexSize));
+    file.write(padding, static_cast<std::streamsize>(header.m_indexOffset - header.m_vertexOffset - header.m_vertexSize));
+    file.write(static_cast<const char*>(mesh.m_indices), static_cast<std::streamsize>(header.m_indexSize));
+    file.close();
+    if (!file) {
+        std::cerr << "Failed to write mesh cache '" << path << "'.\n";
+        std::filesystem::remove(temporary_path, error);
+        return false;
+    }
+
+    std::filesystem::rename(temporary_path, path, error);
+    if (error) {
+        std::cerr << "Failed to write mesh cache '" << path << "'.\n";
+        return false;
+    }
+    return true;
+}
+
+MappedMesh::MappedMesh() : m_mapping(nullptr), m_size(0) {
+}
+
+MappedMesh::~MappedMesh() {
+    release();
+}
+
+bool MappedMesh::open(const std::string& path, std::uint64_t key, bool verifyChecksum) {
+    release();
+
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+    struct stat status;
+    if ((fstat(file, &status) != 0) || (static_cast<size_t>(status.st_size) < sizeof(MeshCacheHeader))) {
+        ::close(file);
+        return false;
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    m_size = static_cast<size_t>(status.st_size);
+    m_mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (m_mapping == MAP_FAILED) {
+        m_mapping = nullptr;
+        m_size = 0;
+        return false;
+    }
+    // the advice values are not flags, so they take a call each. Advice
+    // is only a hint, a failure is reported but the mapping still works
+    for (int advice : {MADV_SEQUENTIAL, MADV_WILLNEED}) {
+        if (madvise(m_mapping, m_size, advice) != 0) {
+            std::cerr << "madvise failed for '" << path << "': " << std::strerror(errno) << "\n";
+        }
+    }
+
+    unsigned char* bytes = static_cast<unsigned char*>(m_mapping);
+    const MeshCacheHeader* header = reinterpret_cast<const MeshCacheHeader*>(bytes);
+    bool valid = (std::memcmp(header->m_magic, MeshCacheHeader::MAGIC, sizeof(header->m_magic)) == 0)
+        && (header->m_version == MeshCacheHeader::VERSION)
+        && (header->m_key == key)
+        && (header->m_vertexStride == static_cast<std::uint32_t>(Mesh::Format::stride))
+        && ((header->m_indexType == GL_UNSIGNED_SHORT) || (header->m_indexType == GL_UNSIGNED_INT))
+        && (header->m_vertexSize == std::uint64_t(header->m_vertexCount)*header->m_vertexStride)
+        && (header->m_indexSize == std::uint64_t(header->m_indexCount)*((header->m_indexType == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint)))
+        && fitsInFile(header->m_vertexOffset, header->m_vertexSize, m_size)
+        && fitsInFile(header->m_indexOffset, header->m_indexSize, m_size);
+    if (valid && verifyChecksum) {
+        std::uint64_t checksum = fnv1a(bytes + header->m_vertexOffset, header->m_vertexSize);
+        checksum = fnv1a(bytes + header->m_indexOffset, header->m_indexSize, checksum);
+        valid = (checksum == header->m_checksum);
+    }
+    if (!valid) {
+        std::cerr << "Mesh cache '" << path << "' is out of date or corrupt.\n";
+        release();
+        return false;
+    }
+
+    m_mesh.m_vertices = reinterpret_cast<GLfloat*>(bytes + header->m_vertexOffset);
+    m_mesh.m_indices = bytes + header->m_indexOffset;
+    m_mesh.m_indexType = header->m_indexType;
+    m_mesh.m_vertexCount = static_cast<GLsizei>(header->m_vertexCount);
+    m_mesh.m_indexCount = static_cast<GLsizei>(header->m_indexCount);
+    return true;
+}
+
+void MappedMesh::release() {
+    if (m_mapping != nullptr) {
+        munmap(m_mapping, m_size);
+        m_mapping = nullptr;
+        m_size = 0;
+    }
+    m_mesh = Mesh();
+}
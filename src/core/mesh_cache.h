@@ -0,0 +1,74 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <cstdint>
+#include <string>
+
+#include "core/mesh.h"
+
+/// Header of a binary mesh cache file. The header is followed by the
+/// vertex blob, in the `Mesh::Format` layout, and the index blob, each
+/// starting on a `MESH_CACHE_ALIGNMENT` byte boundary so they can be
+/// used in place once the file is mapped.
+struct MeshCacheHeader {
+    static constexpr char MAGIC[4] = {'T', 'G', 'L', 'M'};
+    /// Bumped whenever the layout of the file changes.
+    static constexpr std::uint32_t VERSION = 1;
+
+    char m_magic[4];
+    std::uint32_t m_version;
+    /// Identifies the parameters the mesh was generated from.
+    std::uint64_t m_key;
+    std::uint32_t m_vertexStride;
+    std::uint32_t m_indexType;
+    std::uint32_t m_vertexCount;
+    std::uint32_t m_indexCount;
+    std::uint64_t m_vertexOffset, m_vertexSize;
+    std::uint64_t m_indexOffset, m_indexSize;
+    /// FNV-1a hash of the vertex blob followed by the index blob, only
+    /// checked by `MappedMesh::open()` when asked to.
+    std::uint64_t m_checksum;
+};
+
+constexpr std::uint64_t MESH_CACHE_ALIGNMENT = 64;
+
+/// Writes a mesh to a cache file. The file is written next to `path`
+/// and renamed into place, so an interrupted write never leaves a
+/// partial cache behind.
+/// @param key Identifies the parameters the mesh was generated from, a
+/// cache is only loaded for the same key.
+/// @return True if the file was written.
+bool writeMeshCache(const std::string& path, const Mesh& mesh, std::uint64_t key);
+
+/// A mesh cache file mapped into memory. `m_mesh` points straight into
+/// the mapping, so the buffers can be passed to `glBufferData` without
+/// being copied first. The mapping is read only, so the mesh must not be
+/// written to.
+class MappedMesh {
+private:
+    void* m_mapping;
+    size_t m_size;
+
+    MappedMesh(const MappedMesh&) = delete;
+    MappedMesh& operator=(const MappedMesh&) = delete;
+public:
+    Mesh m_mesh;
+
+    MappedMesh();
+    ~MappedMesh();
+
+    /// Maps a cache file and validates its header against the current
+    /// format. Only the header is read, the blobs are paged in when the
+    /// mesh is used.
+    /// @param key Key the cache must have been written with.
+    /// @param verifyChecksum Also hashes both blobs and compares them with
+    /// the checksum written with the file, which reads the whole file.
+    /// @return True if the file exists, has the current version, key and
+    /// vertex format and its blobs fit in the file, and with
+    /// `verifyChecksum` if the checksum matches.
+    bool open(const std::string& path, std::uint64_t key, bool verifyChecksum=false);
+    /// Unmaps the file, invalidating `m_mesh`.
+    void release();
+};
+
+#endif
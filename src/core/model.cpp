@@ -1,40 +1,75 @@
 #include "core/model.h"
 
-Model::Model(GLuint shaderID) {
-    m_matrixID = glGetUniformLocation(shaderID, "ModelTransform");
-}
+#include <cstdint>
+
+#include "core/render_stats.h"
 
 void Model::releaseBuffers() {
-    glDeleteBuffers(1, &m_vertexbuffer);
-    glDeleteBuffers(1, &m_colorbuffer);
+    m_ownedVertexArray.reset();
+    m_ownedVertexbuffer.reset();
+    m_ownedIndexbuffer.reset();
+    m_vertexArray = m_vertexbuffer = m_indexbuffer = 0;
+    m_setAttributes = nullptr;
 }
 
-void Model::setVertexBuffer(GLfloat data[], GLsizei bufferSize) {
-    m_vertexBufferSize = bufferSize;
-    glGenBuffers(1, &m_vertexbuffer);
-    glBindBuffer(GL_ARRAY_BUFFER, m_vertexbuffer);
-    glBufferData(GL_ARRAY_BUFFER, bufferSize, data, GL_STATIC_DRAW);
+void Model::bindNewVertexArray() {
+    if (!m_ownedVertexArray) {
+        m_ownedVertexArray = GLVertexArray::create();
+    }
+    m_vertexArray = m_ownedVertexArray.get();
+    glBindVertexArray(m_vertexArray);
 }
 
-void Model::setColorBuffer(GLfloat data[], GLsizei bufferSize) {
-    glGenBuffers(1, &m_colorbuffer);
-    glBindBuffer(GL_ARRAY_BUFFER, m_colorbuffer);
-    glBufferData(GL_ARRAY_BUFFER, bufferSize, data, GL_STATIC_DRAW);
+void Model::attachVertexBuffer(GLuint buffer, void (*setAttributes)()) {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    setAttributes();
+    m_setAttributes = setAttributes;
 }
 
-void Model::drawModel(glm::mat4 modelSpaceToWorldSpace) {
-    glUniformMatrix4fv(m_matrixID, 1, GL_FALSE, &modelSpaceToWorldSpace[0][0]);
+void Model::setBounds(const BoundingBox& box) {
+    m_bounds = boundsFromBox(box);
+}
 
-    glEnableVertexAttribArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, m_vertexbuffer);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+void Model::setIndexBuffer(const void* data, GLsizei indexCount, GLenum indexType) {
+    m_indexCount = indexCount;
+    m_indexType = indexType;
+    GLsizeiptr indexSize = (indexType == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint);
 
-    glEnableVertexAttribArray(1);
-    glBindBuffer(GL_ARRAY_BUFFER, m_colorbuffer);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    // the element buffer binding is part of the vertex array state
+    bindNewVertexArray();
+    if (!m_ownedIndexbuffer) {
+        m_ownedIndexbuffer = GLBuffer::create();
+    }
+    m_indexbuffer = m_ownedIndexbuffer.get();
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexbuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount*indexSize, data, GL_STATIC_DRAW);
+}
 
-    glDrawArrays(GL_TRIANGLES, 0, m_vertexBufferSize/(3*sizeof(GLfloat)));
+void Model::bind() const {
+    glBindVertexArray(m_vertexArray);
+    RenderStats::getInstance()->m_bindCalls++;
+}
 
-    glDisableVertexAttribArray(1);
-    glDisableVertexAttribArray(0);
+void Model::drawModelInstanced(GLsizei instanceCount, GLuint baseInstance) const {
+    GLsizei count;
+    if (m_indexCount > 0) {
+        std::uintptr_t offset = m_firstIndex*((m_indexType == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint));
+        if (baseInstance == 0) {
+            glDrawElementsInstancedBaseVertex(GL_TRIANGLES, m_indexCount, m_indexType, reinterpret_cast<void*>(offset), instanceCount, m_baseVertex);
+        } else {
+            glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, m_indexCount, m_indexType, reinterpret_cast<void*>(offset),
+                                                          instanceCount, m_baseVertex, baseInstance);
+        }
+        count = m_indexCount;
+    } else {
+        if (baseInstance == 0) {
+            glDrawArraysInstanced(GL_TRIANGLES, m_baseVertex, m_vertexCount, instanceCount);
+        } else {
+            glDrawArraysInstancedBaseInstance(GL_TRIANGLES, m_baseVertex, m_vertexCount, instanceCount, baseInstance);
+        }
+        count = m_vertexCount;
+    }
+    RenderStats* stats = RenderStats::getInstance();
+    stats->m_drawCalls++;
+    stats->m_triangles += static_cast<unsigned long>(count/3)*static_cast<unsigned long>(instanceCount);
 }
@@ -6,19 +6,118 @@
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 
+#include "core/bounds.h"
+#include "core/gl_object.h"
+#include "core/resource_registry.h"
+#include "core/stream_buffer.h"
+#include "core/vertex_format.h"
+
 /// A class for storing model data that can be resued between multiple objects.
+/// Each model owns a vertex array object that records its interleaved
+/// vertex layout and index buffer, so drawing only needs to bind the
+/// vertex array. If an index buffer is set the model is drawn with
+/// `glDrawElements`, otherwise the vertex buffer is drawn as a list of
+/// triangles. Setting a buffer again reuses the existing buffer object.
+///
+/// A model owns the objects it creates and deletes them when destroyed,
+/// so models can be moved but not copied, objects refer to them through
+/// a `ModelHandle` instead. Models of a `GeometryPool` or a
+/// `StreamBuffer` only borrow those buffers.
 class Model {
+private:
+    GLVertexArray m_ownedVertexArray;
+    GLBuffer m_ownedVertexbuffer;
+    GLBuffer m_ownedIndexbuffer;
+
+    /// Creates the vertex array object if the model does not own one yet
+    /// and binds it.
+    void bindNewVertexArray();
+    /// Points the vertex array at `buffer` using the given vertex layout.
+    void attachVertexBuffer(GLuint buffer, void (*setAttributes)());
 public:
-    GLuint m_vertexbuffer;
-    GLuint m_colorbuffer;
-    GLsizei m_vertexBufferSize;
-    GLuint m_matrixID;
+    /// Names of the objects the model is drawn with, owned by the model
+    /// or borrowed.
+    GLuint m_vertexArray = 0;
+    GLuint m_vertexbuffer = 0;
+    GLuint m_indexbuffer = 0;
+    /// Sets up the vertex layout of the vertex buffer on the bound vertex
+    /// array, for renderers that draw the model from vertex arrays of
+    /// their own.
+    void (*m_setAttributes)() = nullptr;
+    GLsizei m_vertexCount = 0;
+    GLsizei m_indexCount = 0;
+    GLenum m_indexType = GL_UNSIGNED_INT;
+    /// Index of the first vertex in the vertex buffer.
+    GLint m_baseVertex = 0;
+    /// Index of the first index in the index buffer.
+    GLuint m_firstIndex = 0;
+    /// Model space bounds of the vertices, computed when the vertex
+    /// buffer is set.
+    Bounds m_bounds;
+
+    Model() = default;
+    Model(Model&&) = default;
+    Model& operator=(Model&&) = default;
 
-    Model(GLuint shaderID);
+    /// Deletes the objects owned by the model, borrowed ones are left alone.
     void releaseBuffers();
-    void setVertexBuffer(GLfloat data[], GLsizei bufferSize);
-    void setColorBuffer(GLfloat data[], GLsizei bufferSize);
-    void drawModel(glm::mat4 modelSpaceToWorldSpace);
+
+    /// Uploads interleaved vertices with the layout given by `Format`.
+    /// @param data Vertex data, `vertexCount*Format::stride` bytes.
+    /// @param vertexCount Number of vertices in the buffer.
+    template<typename Format>
+    void setVertexBuffer(const void* data, GLsizei vertexCount) {
+        bindNewVertexArray();
+        if (!m_ownedVertexbuffer) {
+            m_ownedVertexbuffer = GLBuffer::create();
+        }
+        m_vertexbuffer = m_ownedVertexbuffer.get();
+        glBindBuffer(GL_ARRAY_BUFFER, m_vertexbuffer);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertexCount)*Format::stride, data, GL_STATIC_DRAW);
+        attachVertexBuffer(m_vertexbuffer, &Format::setAttributes);
+
+        m_vertexCount = vertexCount;
+        m_baseVertex = 0;
+        m_bounds = computeBounds(data, static_cast<size_t>(vertexCount), Format::stride);
+    }
+
+    /// Reads interleaved vertices with the layout given by `Format` from
+    /// the current region of a stream buffer. The vertex array is only
+    /// set up the first time, afterwards this just selects the region.
+    /// The stream buffer stays owned by the caller.
+    template<typename Format>
+    void setVertexStream(const StreamBuffer& stream) {
+        if (m_vertexbuffer != stream.getBuffer()) {
+            bindNewVertexArray();
+            attachVertexBuffer(stream.getBuffer(), &Format::setAttributes);
+            m_ownedVertexbuffer.reset();
+            m_vertexbuffer = stream.getBuffer();
+        }
+        m_vertexCount = static_cast<GLsizei>(stream.getRegionSize()/Format::stride);
+        m_baseVertex = static_cast<GLint>(stream.getRegionOffset()/Format::stride);
+    }
+
+    /// Sets the bounds of a model whose vertices change over time, such
+    /// as a streamed model, to a box containing all of its vertices.
+    void setBounds(const BoundingBox& box);
+
+    /// Sets the triangle indices used to draw the model.
+    /// @param data Index buffer of either `GLushort` or `GLuint`.
+    /// @param indexCount Number of indices in the buffer.
+    /// @param indexType Either `GL_UNSIGNED_SHORT` or `GL_UNSIGNED_INT`.
+    void setIndexBuffer(const void* data, GLsizei indexCount, GLenum indexType);
+
+    /// Binds the vertex array of the model.
+    void bind() const;
+    /// Draws `instanceCount` instances of the model. The vertex array
+    /// must already be bound with `bind()` and have its per-instance
+    /// attributes set up by the caller.
+    /// @param baseInstance Offset added to the instance index when fetching
+    /// per-instance attributes, anything but 0 needs `ARB_base_instance`.
+    void drawModelInstanced(GLsizei instanceCount, GLuint baseInstance=0) const;
 };
 
+using ModelRegistry = ResourceRegistry<Model>;
+using ModelHandle = ModelRegistry::Handle;
+
 #endif
@@ -1,14 +1,15 @@
 #include "core/object.h"
 
-Object::Object(Model model) : m_model(model) {
+Object::Object(ModelHandle model) : m_model(model) {
     m_modelSpaceToWorldSpace = glm::translate(glm::mat4(1.f), m_position);
 }
 
-void Object::drawObject() {
-    this->m_model.drawModel(m_modelSpaceToWorldSpace);
+Object::Object(const LodChain* lodChain) : m_model(lodChain->getLevel(0)), m_lodChain(lodChain) {
+    m_modelSpaceToWorldSpace = glm::translate(glm::mat4(1.f), m_position);
 }
 
 void Object::update(float dt) {
+    m_previousPosition = m_position;
     m_velocity += 0.5f*dt*m_acceleration;
     m_position += dt*m_velocity;
     m_velocity += 0.5f*dt*m_acceleration;
@@ -19,3 +20,23 @@ void Object::update(float dt) {
         m_velocity.y *= -0.9f;
     }
 }
+
+void Object::interpolate(float alpha) {
+    m_modelSpaceToWorldSpace = glm::translate(glm::mat4(1.0f), glm::mix(m_previousPosition, m_position, alpha));
+}
+
+Bounds Object::getWorldBounds(const ModelRegistry& models) const {
+    const Model* model = models.get(m_model);
+    return transformBounds((model != nullptr) ? model->m_bounds : Bounds(), m_modelSpaceToWorldSpace);
+}
+
+void Object::selectLod(float screenSize) {
+    if (m_lodChain == nullptr) {
+        return;
+    }
+    size_t level = m_lodChain->selectLevel(screenSize, m_lod);
+    if (level != m_lod) {
+        m_lod = level;
+        m_model = m_lodChain->getLevel(level);
+    }
+}
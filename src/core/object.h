@@ -4,22 +4,45 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/transform.hpp>
 
+#include "core/bounds.h"
+#include "core/lod.h"
 #include "core/model.h"
 
-/// A class for defining objects using a given model.
+/// A class for defining objects using a given model. Objects created from
+/// a `LodChain` switch their model between the levels of the chain in
+/// `selectLod()`. The model is referenced by handle, so any number of
+/// objects can share a model without copying it.
 class Object {
 public:
-    Model m_model;
+    ModelHandle m_model;
+    /// Levels of detail of the model, owned by the caller. Null if the
+    /// object always uses the same model.
+    const LodChain* m_lodChain = nullptr;
+    /// Level of `m_lodChain` currently in `m_model`.
+    size_t m_lod = 0;
     float m_mass=1.f;
     glm::vec3 m_position = glm::vec3(0.0f);
+    /// Position before the last call to `update()`, for interpolation.
+    glm::vec3 m_previousPosition = glm::vec3(0.0f);
     glm::vec3 m_velocity = glm::vec3(0.0f);
     glm::vec3 m_acceleration = glm::vec3(0.0f);
 
     glm::mat4 m_modelSpaceToWorldSpace;
 
-    Object(Model model);
-    void drawObject();
+    Object(ModelHandle model);
+    /// Creates an object starting at the most detailed level of the chain.
+    Object(const LodChain* lodChain);
     void update(float dt);
+    /// Places the object between its previous and current position.
+    /// @param alpha Interpolation factor, 0 for the previous position and
+    /// 1 for the current one.
+    void interpolate(float alpha);
+    /// @return Bounds of the model in world space, empty bounds at the
+    /// object's position if the model no longer exists.
+    Bounds getWorldBounds(const ModelRegistry& models) const;
+    /// Switches to the level of detail for the given screen size.
+    /// @param screenSize Fraction of the viewport height covered by the object.
+    void selectLod(float screenSize);
 };
 
 #endif
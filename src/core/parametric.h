@@ -0,0 +1,86 @@
+#ifndef PARAMETRIC_H
+#define PARAMETRIC_H
+
+#include <algorithm>
+
+// keep this before all other OpenGL libraries
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+#include "core/arena.h"
+#include "core/job_system.h"
+#include "core/mesh.h"
+#include "core/simd_math.h"
+
+/// Number of grid rows evaluated by each job of `evaluateParametricGrid()`.
+constexpr size_t PARAMETRIC_ROWS_PER_JOB = 8;
+
+/// Evaluates a parametric surface on a regular grid on the unit square,
+/// storing the points row by row like `evaluateGrid()`. The function is
+/// called on four neighbouring grid points of a row at a time, so it can
+/// use the vector math of `simd_math.h`, and the rows are split across
+/// the workers of `jobs`. The function should have the signature
+/// `void(Float4 u, Float4 v, Float4 position[3], Float4 color[3])` and
+/// must be safe to call from several threads at once. Rows whose length
+/// is not a multiple of four are padded with points past the end of the
+/// row, which are evaluated but not stored. Like `gridPoint()` an axis
+/// with a resolution of 1 has its single point at 0.
+/// @param vertices Destination for the interleaved position and color
+/// of each grid point in the `Mesh::Format` layout.
+template<typename Function>
+void evaluateParametricGrid(int x_resolution, int y_resolution, Function function, GLfloat* vertices, JobSystem& jobs) {
+    constexpr size_t vertex_floats = Mesh::Format::stride/sizeof(GLfloat);
+    static_assert(vertex_floats == 6, "the vertices must hold a position and a color");
+    if ((x_resolution < 1) || (y_resolution < 1)) {
+        return;
+    }
+
+    const Float4 x_scale = static_cast<float>(std::max(x_resolution - 1, 1));
+    const float y_scale = static_cast<float>(std::max(y_resolution - 1, 1));
+    jobs.parallelFor(static_cast<size_t>(y_resolution), PARAMETRIC_ROWS_PER_JOB, [&](size_t begin, size_t end) {
+        for (size_t column_index = begin; column_index < end; column_index++) {
+            Float4 v = static_cast<float>(column_index)/y_scale;
+            GLfloat* row = vertices + vertex_floats*column_index*static_cast<size_t>(x_resolution);
+
+            for (int row_index = 0; row_index < x_resolution; row_index += 4) {
+                float indices[4];
+                for (int lane = 0; lane < 4; lane++) {
+                    indices[lane] = static_cast<float>(row_index + lane);
+                }
+                Float4 u = Float4::load(indices)/x_scale;
+
+                Float4 position[3], color[3];
+                function(u, v, position, color);
+
+                // transpose the four points back into interleaved vertices
+                float lanes[vertex_floats][4];
+                for (int i = 0; i < 3; i++) {
+                    position[i].store(lanes[i]);
+                    color[i].store(lanes[3 + i]);
+                }
+                int count = std::min(4, x_resolution - row_index);
+                for (int lane = 0; lane < count; lane++) {
+                    GLfloat* vertex = row + vertex_floats*static_cast<size_t>(row_index + lane);
+                    for (size_t i = 0; i < vertex_floats; i++) {
+                        vertex[i] = lanes[i][lane];
+                    }
+                }
+            }
+        }
+    });
+}
+
+/// Builds an indexed mesh over a regular grid on the unit square like
+/// `buildGridMesh()`, evaluating the surface with `evaluateParametricGrid()`.
+template<typename Function>
+Mesh buildParametricMesh(Arena& arena, int x_resolution, int y_resolution, Function function, JobSystem& jobs) {
+    Mesh mesh;
+    mesh.m_vertexCount = x_resolution*y_resolution;
+    mesh.m_vertices = arena.allocate<GLfloat>(Mesh::Format::stride/sizeof(GLfloat)*static_cast<size_t>(mesh.m_vertexCount));
+
+    evaluateParametricGrid(x_resolution, y_resolution, function, mesh.m_vertices, jobs);
+    buildGridIndices(arena, mesh, x_resolution, y_resolution);
+    return mesh;
+}
+
+#endif
@@ -0,0 +1,177 @@
+#include "core/physics_world.h"
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+size_t PhysicsWorld::addBody(glm::vec3 position, glm::vec3 velocity, glm::vec3 acceleration, float mass) {
+    m_positionX.push_back(position.x);
+    m_positionY.push_back(position.y);
+    m_positionZ.push_back(position.z);
+    m_velocityX.push_back(velocity.x);
+    m_velocityY.push_back(velocity.y);
+    m_velocityZ.push_back(velocity.z);
+    m_accelerationX.push_back(acceleration.x);
+    m_accelerationY.push_back(acceleration.y);
+    m_accelerationZ.push_back(acceleration.z);
+    m_mass.push_back(mass);
+    m_transforms.push_back(glm::mat4(1.f));
+    return m_mass.size() - 1;
+}
+
+size_t PhysicsWorld::size() const {
+    return m_mass.size();
+}
+
+glm::vec3 PhysicsWorld::getPosition(size_t index) const {
+    return glm::vec3(m_positionX[index], m_positionY[index], m_positionZ[index]);
+}
+
+glm::vec3 PhysicsWorld::getVelocity(size_t index) const {
+    return glm::vec3(m_velocityX[index], m_velocityY[index], m_velocityZ[index]);
+}
+
+void PhysicsWorld::step(float dt) {
+    step(dt, 0, size());
+}
+
+/// The vector kernels perform exactly the same single precision
+/// operations in the same order as `Object::update`, so every lane is
+/// bit identical to the scalar integrator. The remaining bodies that do
+/// not fill a full vector are handled by the scalar loop.
+void PhysicsWorld::step(float dt, size_t begin, size_t end) {
+    float* px = m_positionX.data();
+    float* py = m_positionY.data();
+    float* pz = m_positionZ.data();
+    float* vx = m_velocityX.data();
+    float* vy = m_velocityY.data();
+    float* vz = m_velocityZ.data();
+    const float* ax = m_accelerationX.data();
+    const float* ay = m_accelerationY.data();
+    const float* az = m_accelerationZ.data();
+
+    const float half_dt = 0.5f*dt;
+    size_t i = begin;
+
+#if defined(__AVX__)
+    const __m256 half_dt8 = _mm256_set1_ps(half_dt);
+    const __m256 dt8 = _mm256_set1_ps(dt);
+    const __m256 zero8 = _mm256_setzero_ps();
+    const __m256 bounce8 = _mm256_set1_ps(-0.9f);
+    for (; i + 8 <= end; i += 8) {
+        __m256 ax8 = _mm256_loadu_ps(ax + i), ay8 = _mm256_loadu_ps(ay + i), az8 = _mm256_loadu_ps(az + i);
+        __m256 vx8 = _mm256_add_ps(_mm256_loadu_ps(vx + i), _mm256_mul_ps(half_dt8, ax8));
+        __m256 vy8 = _mm256_add_ps(_mm256_loadu_ps(vy + i), _mm256_mul_ps(half_dt8, ay8));
+        __m256 vz8 = _mm256_add_ps(_mm256_loadu_ps(vz + i), _mm256_mul_ps(half_dt8, az8));
+
+        __m256 px8 = _mm256_add_ps(_mm256_loadu_ps(px + i), _mm256_mul_ps(dt8, vx8));
+        __m256 py8 = _mm256_add_ps(_mm256_loadu_ps(py + i), _mm256_mul_ps(dt8, vy8));
+        __m256 pz8 = _mm256_add_ps(_mm256_loadu_ps(pz + i), _mm256_mul_ps(dt8, vz8));
+
+        vx8 = _mm256_add_ps(vx8, _mm256_mul_ps(half_dt8, ax8));
+        vy8 = _mm256_add_ps(vy8, _mm256_mul_ps(half_dt8, ay8));
+        vz8 = _mm256_add_ps(vz8, _mm256_mul_ps(half_dt8, az8));
+
+        // fake a floor
+        __m256 below = _mm256_cmp_ps(py8, zero8, _CMP_LT_OQ);
+        __m256 moving_down = _mm256_cmp_ps(_mm256_mul_ps(vy8, py8), zero8, _CMP_GT_OQ);
+        vy8 = _mm256_blendv_ps(vy8, _mm256_mul_ps(vy8, bounce8), _mm256_and_ps(below, moving_down));
+
+        _mm256_storeu_ps(px + i, px8);
+        _mm256_storeu_ps(py + i, py8);
+        _mm256_storeu_ps(pz + i, pz8);
+        _mm256_storeu_ps(vx + i, vx8);
+        _mm256_storeu_ps(vy + i, vy8);
+        _mm256_storeu_ps(vz + i, vz8);
+    }
+#endif
+
+#if defined(__SSE2__)
+    const __m128 half_dt4 = _mm_set1_ps(half_dt);
+    const __m128 dt4 = _mm_set1_ps(dt);
+    const __m128 zero4 = _mm_setzero_ps();
+    const __m128 bounce4 = _mm_set1_ps(-0.9f);
+    for (; i + 4 <= end; i += 4) {
+        __m128 ax4 = _mm_loadu_ps(ax + i), ay4 = _mm_loadu_ps(ay + i), az4 = _mm_loadu_ps(az + i);
+        __m128 vx4 = _mm_add_ps(_mm_loadu_ps(vx + i), _mm_mul_ps(half_dt4, ax4));
+        __m128 vy4 = _mm_add_ps(_mm_loadu_ps(vy + i), _mm_mul_ps(half_dt4, ay4));
+        __m128 vz4 = _mm_add_ps(_mm_loadu_ps(vz + i), _mm_mul_ps(half_dt4, az4));
+
+        __m128 px4 = _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(dt4, vx4));
+        __m128 py4 = _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(dt4, vy4));
+        __m128 pz4 = _mm_add_ps(_mm_loadu_ps(pz + i), _mm_mul_ps(dt4, vz4));
+
+        vx4 = _mm_add_ps(vx4, _mm_mul_ps(half_dt4, ax4));
+        vy4 = _mm_add_ps(vy4, _mm_mul_ps(half_dt4, ay4));
+        vz4 = _mm_add_ps(vz4, _mm_mul_ps(half_dt4, az4));
+
+        // fake a floor
+        __m128 bounce = _mm_and_ps(_mm_cmplt_ps(py4, zero4), _mm_cmpgt_ps(_mm_mul_ps(vy4, py4), zero4));
+        vy4 = _mm_or_ps(_mm_and_ps(bounce, _mm_mul_ps(vy4, bounce4)), _mm_andnot_ps(bounce, vy4));
+
+        _mm_storeu_ps(px + i, px4);
+        _mm_storeu_ps(py + i, py4);
+        _mm_storeu_ps(pz + i, pz4);
+        _mm_storeu_ps(vx + i, vx4);
+        _mm_storeu_ps(vy + i, vy4);
+        _mm_storeu_ps(vz + i, vz4);
+    }
+#endif
+
+    for (; i < end; i++) {
+        vx[i] += half_dt*ax[i];
+        vy[i] += half_dt*ay[i];
+        vz[i] += half_dt*az[i];
+        px[i] += dt*vx[i];
+        py[i] += dt*vy[i];
+        pz[i] += dt*vz[i];
+        vx[i] += half_dt*ax[i];
+        vy[i] += half_dt*ay[i];
+        vz[i] += half_dt*az[i];
+
+        // fake a floor
+        if ((py[i] < 0) && (vy[i]*py[i] > 0)) {
+            vy[i] *= -0.9f;
+        }
+    }
+}
+
+void PhysicsWorld::buildTransforms() {
+    buildTransforms(0, size());
+}
+
+/// Each matrix is the identity with the body's position in the last
+/// column. Four positions are transposed into four translation columns
+/// at a time and the matrices are written with full width stores.
+void PhysicsWorld::buildTransforms(size_t begin, size_t end) {
+    float* transforms = &m_transforms.data()[0][0][0];
+    size_t i = begin;
+
+#if defined(__SSE2__)
+    const __m128 column0 = _mm_setr_ps(1.f, 0.f, 0.f, 0.f);
+    const __m128 column1 = _mm_setr_ps(0.f, 1.f, 0.f, 0.f);
+    const __m128 column2 = _mm_setr_ps(0.f, 0.f, 1.f, 0.f);
+    for (; i + 4 <= end; i += 4) {
+        __m128 x = _mm_loadu_ps(m_positionX.data() + i);
+        __m128 y = _mm_loadu_ps(m_positionY.data() + i);
+        __m128 z = _mm_loadu_ps(m_positionZ.data() + i);
+        __m128 w = _mm_set1_ps(1.f);
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        const __m128 translations[4] = {x, y, z, w};
+
+        for (size_t j = 0; j < 4; j++) {
+            float* matrix = transforms + 16*(i + j);
+            _mm_storeu_ps(matrix + 0, column0);
+            _mm_storeu_ps(matrix + 4, column1);
+            _mm_storeu_ps(matrix + 8, column2);
+            _mm_storeu_ps(matrix + 12, translations[j]);
+        }
+    }
+#endif
+
+    for (; i < end; i++) {
+        glm::mat4& matrix = m_transforms[i];
+        matrix = glm::mat4(1.f);
+        matrix[3] = glm::vec4(m_positionX[i], m_positionY[i], m_positionZ[i], 1.f);
+    }
+}
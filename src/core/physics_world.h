@@ -0,0 +1,48 @@
+#ifndef PHYSICS_WORLD_H
+#define PHYSICS_WORLD_H
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "core/aligned_allocator.h"
+
+/// A headless container for simulating many bodies at once. The state
+/// of the bodies is stored as a structure of arrays so that the
+/// integrator can update several bodies per instruction with SSE or AVX.
+/// Each step gives bit for bit the same result as `Object::update` would
+/// for the same body, including the fake floor. This holds as long as
+/// both are compiled without fusing multiplies and adds, which the build
+/// turns off for them.
+class PhysicsWorld {
+public:
+    template<typename T>
+    using AlignedVector = std::vector<T, AlignedAllocator<T, 32>>;
+
+    AlignedVector<float> m_positionX, m_positionY, m_positionZ;
+    AlignedVector<float> m_velocityX, m_velocityY, m_velocityZ;
+    AlignedVector<float> m_accelerationX, m_accelerationY, m_accelerationZ;
+    AlignedVector<float> m_mass;
+    /// Model space to world space matrix of each body, filled by
+    /// `buildTransforms()`.
+    AlignedVector<glm::mat4> m_transforms;
+
+    /// Adds a body to the world.
+    /// @return Index of the new body.
+    size_t addBody(glm::vec3 position, glm::vec3 velocity, glm::vec3 acceleration, float mass=1.f);
+    /// @return Number of bodies in the world.
+    size_t size() const;
+    glm::vec3 getPosition(size_t index) const;
+    glm::vec3 getVelocity(size_t index) const;
+
+    /// Advances all bodies by one velocity Verlet step.
+    void step(float dt);
+    /// Advances the bodies in [begin, end) by one velocity Verlet step.
+    void step(float dt, size_t begin, size_t end);
+    /// Rebuilds the translation matrices of all bodies.
+    void buildTransforms();
+    /// Rebuilds the translation matrices of the bodies in [begin, end).
+    void buildTransforms(size_t begin, size_t end);
+};
+
+#endif
@@ -0,0 +1,174 @@
+#include "core/profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+thread_local std::uint32_t ProfileScope::m_depth = 0;
+
+Profiler::Profiler() {
+    for (std::atomic<ProfileRing*>& ring : m_rings) {
+        ring = nullptr;
+    }
+    m_ringCount = 0;
+    m_frameCount = 0;
+    m_dropped = 0;
+    m_traceCount = 0;
+    m_zones.reserve(MAX_ZONES);
+    m_startTime = m_previousUpdate = now();
+    m_loopLog = LoopLog::getInstance();
+}
+
+/// As with `LoopLog` the instance is created by a function local
+/// static, since the first scope may close on a worker thread.
+Profiler* Profiler::getInstance() {
+    static Profiler* instance = new Profiler();
+    return instance;
+}
+
+std::uint64_t Profiler::now() {
+    auto time = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+}
+
+ProfileRing* Profiler::threadRing() {
+    // like `LoopLog::threadRing()` every thread takes an index only once,
+    // so threads without a ring never wrap the count around
+    thread_local bool has_index = false;
+    thread_local ProfileRing* ring = nullptr;
+    if (!has_index) {
+        has_index = true;
+        std::uint32_t index = m_ringCount.fetch_add(1);
+        if (index < MAX_THREADS) {
+            // rings are never freed so the profiler can still drain them
+            // after their thread has exited
+            ring = new ProfileRing();
+            ring->m_threadIndex = index;
+            m_rings[index].store(ring, std::memory_order_release);
+        }
+    }
+    return ring;
+}
+
+void Profiler::endFrame() {
+    m_frameCount++;
+    std::uint32_t dropped = 0;
+    for (std::atomic<ProfileRing*>& ring_pointer : m_rings) {
+        ProfileRing* ring = ring_pointer.load(std::memory_order_acquire);
+        if (ring == nullptr) {
+            continue;
+        }
+
+        std::uint32_t tail = ring->m_tail.load(std::memory_order_relaxed);
+        std::uint32_t head = ring->m_head.load(std::memory_order_acquire);
+        for (; tail != head; tail++) {
+            const ProfileEvent& event = ring->m_events[tail % ProfileRing::CAPACITY];
+
+            ZoneStats* zone = nullptr;
+            for (ZoneStats& candidate : m_zones) {
+                if ((candidate.m_name == event.m_name) && (candidate.m_depth == event.m_depth)) {
+                    zone = &candidate;
+                    break;
+                }
+            }
+            if ((zone == nullptr) && (m_zones.size() < MAX_ZONES)) {
+                m_zones.push_back(ZoneStats{event.m_name, event.m_depth, event.m_start, 0, 0});
+                zone = &m_zones.back();
+            }
+            if (zone != nullptr) {
+                zone->m_total += event.m_end - event.m_start;
+                zone->m_calls++;
+            } else {
+                dropped++;
+            }
+
+            if (!m_trace.empty()) {
+                m_trace[m_traceCount % m_trace.size()] = TraceEvent{event, ring->m_threadIndex};
+                m_traceCount++;
+            }
+        }
+        ring->m_tail.store(tail, std::memory_order_release);
+        dropped += ring->m_dropped.exchange(0, std::memory_order_relaxed);
+    }
+    m_dropped += dropped;
+
+    std::uint64_t time = now();
+    if (time - m_previousUpdate >= 1000000000) {
+        // parents start before their children so this lists the zones as a tree
+        std::sort(m_zones.begin(), m_zones.end(), [](const ZoneStats& a, const ZoneStats& b) {
+            return a.m_firstStart < b.m_firstStart;
+        });
+
+        double frames = static_cast<double>(m_frameCount);
+        m_loopLog->m_log << "Zone (ms per frame | calls per frame), dropped zones: " << m_dropped << "\n";
+        for (ZoneStats& zone : m_zones) {
+            m_loopLog->m_log << "  ";
+            for (std::uint32_t i = 0; i < zone.m_depth; i++) {
+                m_loopLog->m_log << "  ";
+            }
+            m_loopLog->m_log << zone.m_name << ": " << 1e-6*static_cast<double>(zone.m_total)/frames
+                             << " | " << static_cast<double>(zone.m_calls)/frames << "\n";
+            zone.m_total = zone.m_calls = 0;
+        }
+        m_previousUpdate = time;
+        m_frameCount = 0;
+        m_dropped = 0;
+    }
+}
+
+void Profiler::enableTrace(size_t maxEvents) {
+    m_trace.assign(maxEvents, TraceEvent());
+    m_traceCount = 0;
+}
+
+void Profiler::writeChromeTrace(const std::string& path) const {
+    if (m_trace.empty()) {
+        return;
+    }
+    std::ofstream stream(path);
+    if (!stream.is_open()) {
+        std::cerr << "Failed to open '" << path << "'.\n";
+        return;
+    }
+
+    // the oldest zone still in the ring comes first
+    std::uint64_t first = (m_traceCount > m_trace.size()) ? m_traceCount - m_trace.size() : 0;
+    stream << "{\"traceEvents\":[\n";
+    for (std::uint64_t i = first; i < m_traceCount; i++) {
+        const TraceEvent& trace = m_trace[i % m_trace.size()];
+        // complete events with times in microseconds since start up
+        stream << "{\"name\":\"" << trace.m_event.m_name << "\",\"ph\":\"X\",\"pid\":1"
+               << ",\"tid\":" << trace.m_threadIndex
+               << ",\"ts\":" << 1e-3*static_cast<double>(trace.m_event.m_start - m_startTime)
+               << ",\"dur\":" << 1e-3*static_cast<double>(trace.m_event.m_end - trace.m_event.m_start) << "}"
+               << ((i + 1 < m_traceCount) ? ",\n" : "\n");
+    }
+    stream << "],\"displayTimeUnit\":\"ms\"}\n";
+    std::clog << "Wrote profile trace to " << path << "\n";
+    if (first > 0) {
+        std::clog << "The trace holds the last " << m_trace.size() << " of " << m_traceCount << " zones\n";
+    }
+}
+
+ProfileScope::ProfileScope(const char* name) : m_name(name) {
+    m_depth++;
+    m_start = Profiler::now();
+}
+
+ProfileScope::~ProfileScope() {
+    std::uint64_t end = Profiler::now();
+    m_depth--;
+
+    ProfileRing* ring = Profiler::getInstance()->threadRing();
+    if (ring == nullptr) {
+        return;
+    }
+    std::uint32_t head = ring->m_head.load(std::memory_order_relaxed);
+    if (head - ring->m_tail.load(std::memory_order_acquire) >= ProfileRing::CAPACITY) {
+        ring->m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ring->m_events[head % ProfileRing::CAPACITY] = ProfileEvent{m_name, m_start, end, m_depth};
+    ring->m_head.store(head + 1, std::memory_order_release);
+}
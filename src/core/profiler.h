@@ -0,0 +1,132 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/looplog.h"
+
+/// A single timed zone as recorded by a `ProfileScope`.
+struct ProfileEvent {
+    const char* m_name;
+    std::uint64_t m_start, m_end;
+    std::uint32_t m_depth;
+};
+
+/// A fixed size single producer, single consumer queue of profile
+/// events. Each thread writes to its own ring and the profiler drains
+/// all rings once per frame.
+struct ProfileRing {
+    static constexpr std::uint32_t CAPACITY = 4096;
+
+    std::array<ProfileEvent, CAPACITY> m_events;
+    std::atomic<std::uint32_t> m_head{0}, m_tail{0};
+    std::atomic<std::uint32_t> m_dropped{0};
+    std::uint32_t m_threadIndex = 0;
+};
+
+/// A singleton hierarchical CPU profiler. Code is instrumented with
+/// `PROFILE_SCOPE("name")` which times the enclosing scope, scopes may
+/// be nested and used from any thread. Once per frame `endFrame()`
+/// collects the zones of every thread, about once a second the average
+/// time per frame of each zone is added to the `LoopLog` buffer. Once
+/// `enableTrace()` is called the latest zones are also kept, to be
+/// written out as a Chrome trace (chrome://tracing or
+/// https://ui.perfetto.dev).
+///
+/// The profiler is compiled out unless the `ENABLE_PROFILER` CMake
+/// option is set, in which case the macros expand to nothing.
+class Profiler {
+private:
+    struct ZoneStats {
+        const char* m_name;
+        std::uint32_t m_depth;
+        std::uint64_t m_firstStart;
+        std::uint64_t m_total;
+        std::uint64_t m_calls;
+    };
+
+    struct TraceEvent {
+        ProfileEvent m_event;
+        std::uint32_t m_threadIndex;
+    };
+
+    static constexpr size_t MAX_THREADS = 64;
+    static constexpr size_t MAX_ZONES = 256;
+
+    std::array<std::atomic<ProfileRing*>, MAX_THREADS> m_rings;
+    std::atomic<std::uint32_t> m_ringCount;
+    /// Both are allocated up front and never grow, so collecting the
+    /// zones does not allocate during the frame. Zones beyond the
+    /// capacity are dropped and counted.
+    std::vector<ZoneStats> m_zones;
+    /// Ring of the latest zones, empty unless the trace is enabled.
+    std::vector<TraceEvent> m_trace;
+    /// Number of zones added to the trace, including overwritten ones.
+    std::uint64_t m_traceCount;
+    std::uint64_t m_frameCount, m_previousUpdate, m_startTime;
+    std::uint64_t m_dropped;
+    LoopLog* m_loopLog;
+
+    Profiler();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+public:
+    /// Trace size of `PROFILE_ENABLE_TRACE()`, a few thousand frames of
+    /// zones in about 2.5 MB.
+    static constexpr size_t DEFAULT_TRACE_EVENTS = 1 << 16;
+
+    /// Gets an instance of the Profiler singleton.
+    /// @return Pointer to an instance of Profiler.
+    static Profiler* getInstance();
+    /// @return Current time in nanoseconds.
+    static std::uint64_t now();
+
+    /// @return The ring of the calling thread, created on first use. Null
+    /// for threads beyond the first `MAX_THREADS`, whose zones are not
+    /// recorded.
+    ProfileRing* threadRing();
+    /// Collects the zones recorded since the previous call. This function
+    /// should only be called once in the render loop.
+    void endFrame();
+    /// Starts keeping the zones for `writeChromeTrace()`. The trace is a
+    /// ring, once it is full the oldest zones are overwritten.
+    /// @param maxEvents Number of zones the trace holds.
+    void enableTrace(size_t maxEvents=DEFAULT_TRACE_EVENTS);
+    /// Writes the zones kept since `enableTrace()` in the Chrome trace
+    /// event format, nothing if the trace was never enabled.
+    void writeChromeTrace(const std::string& path) const;
+};
+
+/// Times the scope it lives in and records it in the calling thread's ring.
+class ProfileScope {
+private:
+    static thread_local std::uint32_t m_depth;
+    const char* m_name;
+    std::uint64_t m_start;
+public:
+    /// @param name Name of the zone, must outlive the profiler, such as
+    /// a string literal.
+    explicit ProfileScope(const char* name);
+    ~ProfileScope();
+};
+
+#ifdef __PROJECT___ENABLE_PROFILER
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#define PROFILE_END_FRAME() Profiler::getInstance()->endFrame()
+#define PROFILE_ENABLE_TRACE() Profiler::getInstance()->enableTrace()
+#define PROFILE_WRITE_TRACE(path) Profiler::getInstance()->writeChromeTrace(path)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_END_FRAME() ((void)0)
+#define PROFILE_ENABLE_TRACE() ((void)0)
+#define PROFILE_WRITE_TRACE(path) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,104 @@
+#include "core/render_queue.h"
+
+#include <cstring>
+#include <utility>
+
+#include "core/render_stats.h"
+
+/// The depth uses the top 16 bits of the float itself, since the bits
+/// of positive floats sort like their values. That keeps 8 bits of the
+/// mantissa, enough to order objects a fraction of a percent apart at
+/// any distance without knowing the depth range.
+std::uint64_t RenderQueue::makeKey(GLuint program, GLuint vertexArray, GLuint texture, float depth) {
+    depth = (depth > 0.f) ? depth : 0.f;
+    std::uint32_t depth_bits;
+    std::memcpy(&depth_bits, &depth, sizeof(depth_bits));
+    return (static_cast<std::uint64_t>(program & 0xFFFF) << 48)
+         | (static_cast<std::uint64_t>(vertexArray & 0xFFFF) << 32)
+         | (static_cast<std::uint64_t>(texture & 0xFFFF) << 16)
+         | static_cast<std::uint64_t>(depth_bits >> 15);
+}
+
+void RenderQueue::submit(GLuint program, const Model& model, const glm::mat4& modelSpaceToWorldSpace, float depth, GLuint texture) {
+    m_entries.push_back(SortEntry{makeKey(program, model.m_vertexArray, texture, depth), static_cast<std::uint32_t>(m_packets.size())});
+    m_packets.push_back(Packet{program, texture, &model, modelSpaceToWorldSpace, 0});
+}
+
+void RenderQueue::sortEntries() {
+    constexpr int num_passes = sizeof(std::uint64_t);
+    size_t counts[num_passes][256] = {};
+    for (const SortEntry& entry : m_entries) {
+        for (int pass = 0; pass < num_passes; pass++) {
+            counts[pass][(entry.m_key >> (8*pass)) & 0xFF]++;
+        }
+    }
+
+    m_scratch.resize(m_entries.size());
+    for (int pass = 0; pass < num_passes; pass++) {
+        size_t* count = counts[pass];
+        int shift = 8*pass;
+        if (count[(m_entries[0].m_key >> shift) & 0xFF] == m_entries.size()) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (int digit = 0; digit < 256; digit++) {
+            size_t digit_count = count[digit];
+            count[digit] = offset;
+            offset += digit_count;
+        }
+        for (const SortEntry& entry : m_entries) {
+            m_scratch[count[(entry.m_key >> shift) & 0xFF]++] = entry;
+        }
+        std::swap(m_entries, m_scratch);
+    }
+}
+
+void RenderQueue::draw(UniformBuffers& uniforms) {
+    if (m_entries.empty()) {
+        return;
+    }
+    sortEntries();
+
+    // the draw blocks are written in draw order so consecutive draws
+    // read neighbouring blocks
+    for (const SortEntry& entry : m_entries) {
+        Packet& packet = m_packets[entry.m_packet];
+        DrawBlock block = DrawBlock();
+        block.m_modelSpaceToWorldSpace = packet.m_modelSpaceToWorldSpace;
+        block.m_instanced = GL_FALSE;
+        packet.m_draw = uniforms.addDraw(block);
+    }
+    uniforms.flush();
+
+    RenderStats* stats = RenderStats::getInstance();
+    const Packet* previous = nullptr;
+    for (const SortEntry& entry : m_entries) {
+        const Packet& packet = m_packets[entry.m_packet];
+        if ((previous == nullptr) || (packet.m_program != previous->m_program)) {
+            glUseProgram(packet.m_program);
+            stats->m_bindCalls++;
+        } else {
+            stats->m_redundantBinds++;
+        }
+        if ((previous == nullptr) || (packet.m_model->m_vertexArray != previous->m_model->m_vertexArray)) {
+            packet.m_model->bind();
+        } else {
+            stats->m_redundantBinds++;
+        }
+        if ((previous == nullptr) || (packet.m_texture != previous->m_texture)) {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, packet.m_texture);
+            stats->m_bindCalls += 2;
+        } else {
+            stats->m_redundantBinds++;
+        }
+
+        uniforms.bindDraw(packet.m_draw);
+        packet.m_model->drawModelInstanced(1);
+        previous = &packet;
+    }
+
+    m_packets.clear();
+    m_entries.clear();
+}
@@ -0,0 +1,71 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <cstdint>
+#include <vector>
+
+// keep this before all other OpenGL libraries
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "core/model.h"
+#include "core/uniform_buffers.h"
+
+/// A renderer that draws objects in the order that needs the fewest
+/// state changes instead of the order they were submitted in. Each draw
+/// is collected as a packet with a 64 bit sort key, and `draw()` radix
+/// sorts the keys and issues the packets in order, skipping the binds of
+/// state that is already bound.
+///
+/// From the most to the least significant bits the key holds the
+/// program, vertex array and texture, 16 bits each, then the depth. The
+/// names are truncated to 16 bits, two names sharing their low bits
+/// only costs some grouping since the binds compare the full names.
+class RenderQueue {
+private:
+    struct Packet {
+        GLuint m_program;
+        GLuint m_texture;
+        /// Owned by the caller, must stay valid until `draw()`.
+        const Model* m_model;
+        glm::mat4 m_modelSpaceToWorldSpace;
+        /// Index of the packet's draw block, set in `draw()`.
+        size_t m_draw;
+    };
+
+    struct SortEntry {
+        std::uint64_t m_key;
+        std::uint32_t m_packet;
+    };
+
+    std::vector<Packet> m_packets;
+    std::vector<SortEntry> m_entries;
+    std::vector<SortEntry> m_scratch;
+
+    /// Sorts `m_entries` by key with an LSD radix sort on bytes. Bytes
+    /// that are the same in every key, such as the program when there
+    /// is only one, are skipped.
+    void sortEntries();
+public:
+    /// @param program Program the packet is drawn with.
+    /// @param vertexArray Vertex array of the model.
+    /// @param texture Texture bound to unit 0, 0 for none.
+    /// @param depth Distance from the camera, negative values sort as 0.
+    /// @return Sort key drawing packets grouped by program, vertex array
+    /// and texture, and front to back within a group.
+    static std::uint64_t makeKey(GLuint program, GLuint vertexArray, GLuint texture, float depth);
+
+    /// Adds a draw to the current frame.
+    /// @param model Model to draw, owned by the caller and read in `draw()`.
+    /// @param depth Distance from the camera to the model.
+    /// @param texture Texture bound to unit 0 for the draw, 0 for none.
+    void submit(GLuint program, const Model& model, const glm::mat4& modelSpaceToWorldSpace, float depth, GLuint texture=0);
+    /// Draws all packets submitted since the last call to `draw()` in
+    /// key order. Nothing is assumed about the state bound before the
+    /// call, the program, vertex array and texture are bound for the
+    /// first packet.
+    void draw(UniformBuffers& uniforms);
+};
+
+#endif
@@ -0,0 +1,45 @@
+#include "core/render_stats.h"
+
+RenderStats* RenderStats::m_instance = nullptr;
+
+RenderStats::RenderStats() {
+    m_previousUpdate = 0;
+    m_loopLog = LoopLog::getInstance();
+    reset();
+}
+
+RenderStats* RenderStats::getInstance() {
+    if (m_instance == nullptr) {
+        m_instance = new RenderStats();
+    }
+    return m_instance;
+}
+
+unsigned long RenderStats::totalCalls() const {
+    return m_drawCalls + m_bindCalls + m_attributeCalls + m_uniformCalls;
+}
+
+void RenderStats::endFrame(double time) {
+    m_frameCount++;
+    if (time - m_previousUpdate >= 1.0) {
+        double frames = static_cast<double>(m_frameCount);
+        m_loopLog->m_log << "GL calls per frame: " << static_cast<double>(totalCalls())/frames
+                         << " [draw | bind | attribute | uniform]: [" << static_cast<double>(m_drawCalls)/frames
+                         << " | " << static_cast<double>(m_bindCalls)/frames
+                         << " | " << static_cast<double>(m_attributeCalls)/frames
+                         << " | " << static_cast<double>(m_uniformCalls)/frames << "]"
+                         << " redundant binds skipped: " << static_cast<double>(m_redundantBinds)/frames << "\n";
+        m_loopLog->m_log << "Objects per frame [visible | culled]: [" << static_cast<double>(m_visibleObjects)/frames
+                         << " | " << static_cast<double>(m_culledObjects)/frames << "]"
+                         << " triangles per frame: " << static_cast<double>(m_triangles)/frames << "\n";
+        m_previousUpdate = time;
+        reset();
+    }
+}
+
+void RenderStats::reset() {
+    m_frameCount = 0;
+    m_drawCalls = m_bindCalls = m_attributeCalls = m_uniformCalls = 0;
+    m_redundantBinds = 0;
+    m_visibleObjects = m_culledObjects = m_triangles = 0;
+}
@@ -0,0 +1,50 @@
+#ifndef RENDER_STATS_H
+#define RENDER_STATS_H
+
+#include "core/looplog.h"
+
+/// A singleton for counting the OpenGL calls made while rendering. The
+/// renderers add to the counters as they issue calls and `endFrame()`
+/// adds the average number of calls per frame to the `LoopLog` buffer
+/// about once a second.
+class RenderStats {
+private:
+    static RenderStats* m_instance;
+
+    unsigned long m_frameCount;
+    double m_previousUpdate;
+    LoopLog* m_loopLog;
+
+    RenderStats();
+
+    RenderStats(const RenderStats&) = delete;
+    RenderStats& operator=(const RenderStats&) = delete;
+public:
+    unsigned long m_drawCalls;
+    unsigned long m_bindCalls;
+    unsigned long m_attributeCalls;
+    unsigned long m_uniformCalls;
+    /// Binds skipped because the state was already bound, these are not
+    /// calls either.
+    unsigned long m_redundantBinds;
+    /// Objects that passed and failed frustum culling, these are not calls
+    /// so they are not part of `totalCalls()`.
+    unsigned long m_visibleObjects;
+    unsigned long m_culledObjects;
+    /// Triangles drawn, including every instance.
+    unsigned long m_triangles;
+
+    /// Gets an instance of the RenderStats singleton.
+    /// @return Pointer to an instance of RenderStats.
+    static RenderStats* getInstance();
+
+    /// @return Total number of counted calls since the last report.
+    unsigned long totalCalls() const;
+    /// Marks the end of a frame and reports the counters once at least
+    /// a second has passed since the last report.
+    /// @param time Current time in seconds.
+    void endFrame(double time);
+    void reset();
+};
+
+#endif
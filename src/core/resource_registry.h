@@ -0,0 +1,115 @@
+#ifndef RESOURCE_REGISTRY_H
+#define RESOURCE_REGISTRY_H
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/// A compact reference to a resource in a `ResourceRegistry<T>`. The
+/// generation tells a handle to a resource apart from a stale handle to
+/// an earlier resource in the same slot. The default handle is null and
+/// never refers to anything.
+template<typename T>
+struct ResourceHandle {
+    std::uint32_t m_index = 0;
+    std::uint32_t m_generation = 0;
+
+    bool isNull() const { return m_generation == 0; }
+    bool operator==(const ResourceHandle& other) const {
+        return (m_index == other.m_index) && (m_generation == other.m_generation);
+    }
+    bool operator!=(const ResourceHandle& other) const { return !(*this == other); }
+};
+
+/// Owns resources of type `T` and hands out handles to them. Removing a
+/// resource destroys it and bumps the generation of its slot, so older
+/// handles to the slot stop resolving instead of reaching whatever is
+/// stored there next. Freed slots are reused, so the storage only grows
+/// with the number of live resources.
+///
+/// Pointers returned by `get()` are only valid until the next `add()`.
+template<typename T>
+class ResourceRegistry {
+public:
+    using Handle = ResourceHandle<T>;
+private:
+    struct Slot {
+        std::optional<T> m_value;
+        /// Generation of the current or next resource in the slot,
+        /// starting at 1 so that null handles never match.
+        std::uint32_t m_generation = 1;
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<std::uint32_t> m_freeSlots;
+    size_t m_size = 0;
+public:
+    /// Takes ownership of a resource.
+    /// @return Handle to the resource.
+    Handle add(T&& value) {
+        std::uint32_t index;
+        if (m_freeSlots.empty()) {
+            index = static_cast<std::uint32_t>(m_slots.size());
+            m_slots.emplace_back();
+        } else {
+            index = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+        Slot& slot = m_slots[index];
+        slot.m_value.emplace(std::move(value));
+        m_size++;
+        return Handle{index, slot.m_generation};
+    }
+
+    /// @return The resource, or null if the handle is null or stale.
+    T* get(Handle handle) {
+        if ((handle.m_index >= m_slots.size()) || (m_slots[handle.m_index].m_generation != handle.m_generation)) {
+            return nullptr;
+        }
+        std::optional<T>& value = m_slots[handle.m_index].m_value;
+        return value ? &*value : nullptr;
+    }
+    const T* get(Handle handle) const {
+        return const_cast<ResourceRegistry*>(this)->get(handle);
+    }
+
+    /// Destroys the resource and invalidates every handle to it.
+    /// @return False if the handle was already null or stale.
+    bool remove(Handle handle) {
+        if (get(handle) == nullptr) {
+            return false;
+        }
+        Slot& slot = m_slots[handle.m_index];
+        slot.m_value.reset();
+        // a slot whose generation would wrap around is retired for good
+        if (++slot.m_generation != 0) {
+            m_freeSlots.push_back(handle.m_index);
+        }
+        m_size--;
+        return true;
+    }
+
+    /// Destroys every resource and invalidates every handle.
+    void clear() {
+        m_freeSlots.clear();
+        for (std::uint32_t i = 0; i < m_slots.size(); i++) {
+            Slot& slot = m_slots[i];
+            if (slot.m_value) {
+                slot.m_value.reset();
+                slot.m_generation++;
+            }
+            if (slot.m_generation != 0) {
+                m_freeSlots.push_back(i);
+            }
+        }
+        m_size = 0;
+    }
+
+    /// @return Number of live resources.
+    size_t size() const {
+        return m_size;
+    }
+};
+
+#endif
@@ -0,0 +1,240 @@
+#include "core/shader_manager.h"
+
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "path_util.h"
+#include "core/shaders.h"
+
+ShaderManager::ShaderManager() {
+    // let the driver use as many compiler threads as it likes
+    m_parallelCompile = false;
+    if (GLEW_KHR_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        m_parallelCompile = true;
+    } else if (GLEW_ARB_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+        m_parallelCompile = true;
+    }
+
+    m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotify < 0) {
+        std::cerr << "Failed to initalize inotify, shaders will not be reloaded.\n";
+    }
+}
+
+void ShaderManager::releasePrograms() {
+    for (Program& program : m_programs) {
+        cancel(program);
+        program.m_program.reset();
+    }
+    if (m_inotify >= 0) {
+        close(m_inotify);
+        m_inotify = -1;
+    }
+    m_watches.clear();
+}
+
+ShaderManager::ProgramHandle ShaderManager::load(const std::string& vertex_file_path, const std::string& fragment_file_path) {
+    Program program;
+    program.m_vertexPath = vertex_file_path;
+    program.m_fragmentPath = fragment_file_path;
+    program.m_pendingShaders[0] = program.m_pendingShaders[1] = 0;
+    program.m_pendingFrames = 0;
+    m_programs.push_back(std::move(program));
+
+    watch(vertex_file_path);
+    watch(fragment_file_path);
+    submit(m_programs.back());
+    return m_programs.size() - 1;
+}
+
+void ShaderManager::submit(Program& program) {
+    cancel(program);
+    program.m_vertexCode = ReadShaderSource(program.m_vertexPath);
+    program.m_fragmentCode = ReadShaderSource(program.m_fragmentPath);
+
+    // only the first load can come from the cache, a reload is always
+    // caused by new sources
+    if (!program.m_program) {
+        program.m_program.reset(LoadCachedProgram(program.m_vertexPath, program.m_fragmentPath, program.m_vertexCode, program.m_fragmentCode));
+        if (program.m_program) {
+            return;
+        }
+    }
+
+    std::clog << "Compiling program : " << program.m_vertexPath << ", " << program.m_fragmentPath << "\n";
+    const std::string* sources[2] = {&program.m_vertexCode, &program.m_fragmentCode};
+    const GLenum types[2] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER};
+    program.m_pending = GLProgram::create();
+    for (int i = 0; i < 2; i++) {
+        GLuint shader = glCreateShader(types[i]);
+        const char* source = sources[i]->c_str();
+        glShaderSource(shader, 1, &source, NULL);
+        glCompileShader(shader);
+        glAttachShader(program.m_pending.get(), shader);
+        program.m_pendingShaders[i] = shader;
+    }
+    if (ProgramCacheEnabled()) {
+        glProgramParameteri(program.m_pending.get(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    // the link is queued behind the compiles, none of these calls wait
+    glLinkProgram(program.m_pending.get());
+    program.m_pendingFrames = 0;
+}
+
+bool ShaderManager::isFinished(const Program& program) const {
+    if (m_parallelCompile) {
+        GLint finished = GL_FALSE;
+        glGetProgramiv(program.m_pending.get(), GL_COMPLETION_STATUS_KHR, &finished);
+        return finished == GL_TRUE;
+    }
+    return program.m_pendingFrames > 0;
+}
+
+void ShaderManager::finish(Program& program) {
+    GLint result = GL_FALSE;
+    glGetProgramiv(program.m_pending.get(), GL_LINK_STATUS, &result);
+    if (result != GL_TRUE) {
+        std::cerr << "Failed to build program : " << program.m_vertexPath << ", " << program.m_fragmentPath << "\n";
+        for (GLuint shader : program.m_pendingShaders) {
+            GLint length = 0;
+            glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+            if (length > 0) {
+                std::vector<char> message(static_cast<size_t>(length) + 1);
+                glGetShaderInfoLog(shader, length, NULL, &message[0]);
+                std::cerr << &message[0];
+            }
+        }
+        GLint length = 0;
+        glGetProgramiv(program.m_pending.get(), GL_INFO_LOG_LENGTH, &length);
+        if (length > 0) {
+            std::vector<char> message(static_cast<size_t>(length) + 1);
+            glGetProgramInfoLog(program.m_pending.get(), length, NULL, &message[0]);
+            std::cerr << &message[0] << "\n";
+        }
+        if (program.m_program) {
+            std::cerr << "Keeping the previous program.\n";
+        }
+        cancel(program);
+        return;
+    }
+
+    BindUniformBlocks(program.m_pending.get());
+    SaveCachedProgram(program.m_vertexPath, program.m_fragmentPath, program.m_vertexCode, program.m_fragmentCode, program.m_pending.get());
+    for (GLuint& shader : program.m_pendingShaders) {
+        glDetachShader(program.m_pending.get(), shader);
+        glDeleteShader(shader);
+        shader = 0;
+    }
+
+    // the old program is only freed by the driver once it is no longer
+    // in use, so it can be deleted while frames using it are in flight
+    if (program.m_program) {
+        std::clog << "Reloaded program : " << program.m_vertexPath << ", " << program.m_fragmentPath << "\n";
+    }
+    program.m_program = std::move(program.m_pending);
+}
+
+void ShaderManager::cancel(Program& program) {
+    if (!program.m_pending) {
+        return;
+    }
+    for (GLuint& shader : program.m_pendingShaders) {
+        glDeleteShader(shader);
+        shader = 0;
+    }
+    program.m_pending.reset();
+}
+
+void ShaderManager::watch(const std::string& path) {
+    if (m_inotify < 0) {
+        return;
+    }
+    std::string directory = get_fixed_path(path).parent_path().string();
+    for (const std::pair<const int, std::string>& entry : m_watches) {
+        if (entry.second == directory) {
+            return;
+        }
+    }
+
+    // editors often save by writing a new file and renaming it over the
+    // old one, so renames count as writes
+    int descriptor = inotify_add_watch(m_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (descriptor < 0) {
+        std::cerr << "Failed to watch '" << directory << "' for changes.\n";
+        return;
+    }
+    m_watches[descriptor] = directory;
+}
+
+/// Drains the inotify events and resubmits every program that uses a
+/// changed file. Several writes to the same file in one frame only cause
+/// one recompile.
+void ShaderManager::pollWatches() {
+    if (m_inotify < 0) {
+        return;
+    }
+
+    std::vector<bool> changed(m_programs.size(), false);
+    alignas(inotify_event) char buffer[4096];
+    ssize_t length;
+    while ((length = read(m_inotify, buffer, sizeof(buffer))) > 0) {
+        for (char* position = buffer; position < buffer + length; ) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(position);
+            position += sizeof(inotify_event) + event->len;
+
+            std::unordered_map<int, std::string>::const_iterator directory = m_watches.find(event->wd);
+            if ((event->len == 0) || (directory == m_watches.end())) {
+                continue;
+            }
+            std::filesystem::path file = std::filesystem::path(directory->second) / event->name;
+            for (size_t i = 0; i < m_programs.size(); i++) {
+                if ((file == get_fixed_path(m_programs[i].m_vertexPath)) || (file == get_fixed_path(m_programs[i].m_fragmentPath))) {
+                    changed[i] = true;
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < m_programs.size(); i++) {
+        if (changed[i]) {
+            try {
+                submit(m_programs[i]);
+            } catch (const std::exception& error) {
+                std::cerr << error.what() << " Keeping the previous program.\n";
+            }
+        }
+    }
+}
+
+void ShaderManager::update() {
+    pollWatches();
+    for (Program& program : m_programs) {
+        if (!program.m_pending) {
+            continue;
+        }
+        if (isFinished(program)) {
+            finish(program);
+        } else {
+            program.m_pendingFrames++;
+        }
+    }
+}
+
+void ShaderManager::wait() {
+    for (Program& program : m_programs) {
+        if (program.m_pending) {
+            finish(program);
+        }
+    }
+}
+
+GLuint ShaderManager::getProgram(ProgramHandle handle) const {
+    return m_programs[handle].m_program.get();
+}
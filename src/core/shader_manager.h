@@ -0,0 +1,85 @@
+#ifndef SHADER_MANAGER_H
+#define SHADER_MANAGER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// keep this before all other OpenGL libraries
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+#include "core/gl_object.h"
+
+/// Compiles shader programs without blocking the render loop and reloads
+/// them when their sources change.
+///
+/// `load()` only submits the shaders to the driver. With
+/// `KHR_parallel_shader_compile` (or the ARB version) the driver compiles
+/// on its own threads and `update()` polls the completion status, so any
+/// number of programs compile at the same time. Without the extension the
+/// status is only checked a frame after submission, giving drivers that
+/// compile in the background a chance to finish before the query blocks.
+///
+/// The directories of the shader files are watched with inotify. When a
+/// file is written every program using it is recompiled, and the new
+/// program replaces the old one in `update()` once it has linked. If it
+/// fails to compile the error is printed and the last good program stays
+/// in use. Programs that are swapped in have their uniform blocks bound
+/// to the shared `UniformBuffers` like any other program, so they need no
+/// uniforms set up again.
+class ShaderManager {
+public:
+    using ProgramHandle = size_t;
+private:
+    struct Program {
+        std::string m_vertexPath, m_fragmentPath;
+        std::string m_vertexCode, m_fragmentCode;
+        /// The last program that linked, empty until the first one has.
+        GLProgram m_program;
+        /// Program being compiled, empty if there is none.
+        GLProgram m_pending;
+        GLuint m_pendingShaders[2];
+        unsigned int m_pendingFrames;
+    };
+
+    std::vector<Program> m_programs;
+    bool m_parallelCompile;
+    int m_inotify;
+    /// Watched directory of each inotify watch descriptor.
+    std::unordered_map<int, std::string> m_watches;
+
+    /// Reads the sources of a program and submits them for compilation,
+    /// replacing any compilation already in progress.
+    void submit(Program& program);
+    /// @return True if the pending program has finished compiling.
+    bool isFinished(const Program& program) const;
+    /// Swaps in the pending program if it linked, otherwise keeps the
+    /// current program and prints the errors.
+    void finish(Program& program);
+    void cancel(Program& program);
+    void watch(const std::string& path);
+    void pollWatches();
+
+    ShaderManager(const ShaderManager&) = delete;
+    ShaderManager& operator=(const ShaderManager&) = delete;
+public:
+    ShaderManager();
+    void releasePrograms();
+
+    /// Starts compiling a program from a vertex and a fragment shader.
+    /// A program in the program binary cache is available immediately.
+    /// @return Handle to get the program with once it has compiled.
+    ProgramHandle load(const std::string& vertex_file_path, const std::string& fragment_file_path);
+    /// Swaps in programs that have finished compiling and starts
+    /// recompiling programs whose sources changed. Should be called once
+    /// per frame.
+    void update();
+    /// Blocks until every pending program has finished compiling.
+    void wait();
+
+    /// @return The current program, 0 if it has not finished compiling.
+    GLuint getProgram(ProgramHandle handle) const;
+};
+
+#endif
@@ -4,14 +4,34 @@
 #include <string>
 #include <iostream>
 #include <fstream>
-#include <sstream>
+#include <filesystem>
+#include <cstring>
+#include <cstdio>
+#include <cstdint>
 #include <stdexcept>
 
 #include "path_util.h"
+#include "core/hash.h"
+#include "core/indirect_renderer.h"
+#include "core/uniform_buffers.h"
 
-GLuint CompileShader(const std::string& shader_file_path, GLenum shader_type){
-    GLuint ShaderID = glCreateShader(shader_type);
+static ShaderCacheStats CacheStats = {0, 0};
+
+/// Header of a program binary cache file, followed by the binary.
+struct ProgramCacheHeader {
+    static constexpr char MAGIC[4] = {'T', 'G', 'L', 'P'};
+    static constexpr std::uint32_t VERSION = 1;
 
+    char m_magic[4];
+    std::uint32_t m_version;
+    /// Hash of the shader sources and the driver strings.
+    std::uint64_t m_key;
+    std::uint32_t m_binaryFormat;
+    std::uint32_t m_binarySize;
+    std::uint64_t m_checksum;
+};
+
+std::string ReadShaderSource(const std::string& shader_file_path){
     std::string fixed_path;
     try {
         fixed_path = get_fixed_path(shader_file_path).string();
@@ -20,25 +40,30 @@ GLuint CompileShader(const std::string& shader_file_path, GLenum shader_type){
         throw;
     }
 
-    //Get Code
+    // read the whole file straight into the string
     std::string ShaderCode;
-    std::ifstream ShaderStream(fixed_path, std::ios::in);
+    std::ifstream ShaderStream(fixed_path, std::ios::in | std::ios::binary | std::ios::ate);
     if (ShaderStream.is_open()) {
-        std::stringstream shader_code;
-        shader_code << ShaderStream.rdbuf();
-        ShaderCode = shader_code.str();
+        ShaderCode.resize(static_cast<size_t>(ShaderStream.tellg()));
+        ShaderStream.seekg(0);
+        ShaderStream.read(&ShaderCode[0], static_cast<std::streamsize>(ShaderCode.size()));
         ShaderStream.close();
     } else {
         std::cerr << "Failed to open '" << shader_file_path << "'.\n";
         throw std::runtime_error("Could not load shader source code.");
     }
+    return ShaderCode;
+}
+
+GLuint CompileShaderSource(const std::string& shader_code, const std::string& shader_name, GLenum shader_type){
+    GLuint ShaderID = glCreateShader(shader_type);
 
     GLint Result = GL_FALSE;
     int InfoLogLength;
 
     //Compile Shader
-    std::clog << "Compiling shader : " << shader_file_path << "\n";
-    char const* SourcePointer = ShaderCode.c_str();
+    std::clog << "Compiling shader : " << shader_name << "\n";
+    char const* SourcePointer = shader_code.c_str();
     glShaderSource(ShaderID, 1, &SourcePointer, NULL);
     glCompileShader(ShaderID);
 
@@ -55,9 +80,148 @@ GLuint CompileShader(const std::string& shader_file_path, GLenum shader_type){
     return ShaderID;
 }
 
+GLuint CompileShader(const std::string& shader_file_path, GLenum shader_type){
+    return CompileShaderSource(ReadShaderSource(shader_file_path), shader_file_path, shader_type);
+}
+
+/// Program binaries can only be cached if the driver supports at least
+/// one binary format.
+static bool ProgramBinarySupported(){
+    if (!GLEW_ARB_get_program_binary) {
+        return false;
+    }
+    GLint FormatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &FormatCount);
+    return FormatCount > 0;
+}
+
+/// Binaries are only valid for the driver that produced them, so the key
+/// covers the driver strings as well as the sources.
+static std::uint64_t ProgramCacheKey(const std::string& vertex_code, const std::string& fragment_code){
+    std::uint64_t Key = FNV_OFFSET_BASIS;
+    for (GLenum Name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        const char* Value = reinterpret_cast<const char*>(glGetString(Name));
+        Key = fnv1a(Value, std::strlen(Value) + 1, Key);
+    }
+    Key = fnv1a(vertex_code.c_str(), vertex_code.size() + 1, Key);
+    return fnv1a(fragment_code.c_str(), fragment_code.size() + 1, Key);
+}
+
+/// @return The program, or 0 if there is no valid cached binary.
+static GLuint LoadProgramBinary(const std::string& cache_path, std::uint64_t key){
+    std::ifstream CacheStream(cache_path, std::ios::in | std::ios::binary);
+    if (!CacheStream.is_open()) {
+        return 0;
+    }
+
+    ProgramCacheHeader Header;
+    if (!CacheStream.read(reinterpret_cast<char*>(&Header), sizeof(Header))
+        || (std::memcmp(Header.m_magic, ProgramCacheHeader::MAGIC, sizeof(Header.m_magic)) != 0)
+        || (Header.m_version != ProgramCacheHeader::VERSION)
+        || (Header.m_key != key)) {
+        return 0;
+    }
+
+    std::vector<char> Binary(Header.m_binarySize);
+    if (!CacheStream.read(Binary.data(), static_cast<std::streamsize>(Binary.size()))
+        || (fnv1a(Binary.data(), Binary.size()) != Header.m_checksum)) {
+        return 0;
+    }
+
+    // the driver may still reject the binary, for example after an update
+    // that did not change the version string
+    GLuint ProgramID = glCreateProgram();
+    glProgramBinary(ProgramID, Header.m_binaryFormat, Binary.data(), static_cast<GLsizei>(Binary.size()));
+    GLint Result = GL_FALSE;
+    glGetProgramiv(ProgramID, GL_LINK_STATUS, &Result);
+    if (Result != GL_TRUE) {
+        glDeleteProgram(ProgramID);
+        return 0;
+    }
+    return ProgramID;
+}
+
+static void SaveProgramBinary(const std::string& cache_path, std::uint64_t key, GLuint program_id){
+    GLint BinaryLength = 0;
+    glGetProgramiv(program_id, GL_PROGRAM_BINARY_LENGTH, &BinaryLength);
+    if (BinaryLength <= 0) {
+        return;
+    }
+
+    ProgramCacheHeader Header;
+    std::vector<char> Binary(static_cast<size_t>(BinaryLength));
+    GLenum BinaryFormat = 0;
+    glGetProgramBinary(program_id, BinaryLength, NULL, &BinaryFormat, Binary.data());
+    std::memcpy(Header.m_magic, ProgramCacheHeader::MAGIC, sizeof(Header.m_magic));
+    Header.m_version = ProgramCacheHeader::VERSION;
+    Header.m_key = key;
+    Header.m_binaryFormat = BinaryFormat;
+    Header.m_binarySize = static_cast<std::uint32_t>(Binary.size());
+    Header.m_checksum = fnv1a(Binary.data(), Binary.size());
+
+    // written next to the cache and renamed so a partial file is never read
+    std::error_code Error;
+    std::filesystem::create_directories(std::filesystem::path(cache_path).parent_path(), Error);
+    std::string TemporaryPath = cache_path + ".tmp";
+    std::ofstream CacheStream(TemporaryPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    CacheStream.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+    CacheStream.write(Binary.data(), static_cast<std::streamsize>(Binary.size()));
+    CacheStream.close();
+    if (!CacheStream) {
+        std::cerr << "Failed to write program cache '" << cache_path << "'.\n";
+        std::filesystem::remove(TemporaryPath, Error);
+        return;
+    }
+    std::filesystem::rename(TemporaryPath, cache_path, Error);
+}
+
+/// One cache file per pair of shaders, replaced whenever the key changes.
+static std::string ProgramCachePath(const std::string& vertex_file_path, const std::string& fragment_file_path){
+    char FileName[32];
+    std::snprintf(FileName, sizeof(FileName), "%016llx.bin", static_cast<unsigned long long>(fnv1a(vertex_file_path + "\n" + fragment_file_path)));
+    return get_fixed_path(std::string("shader_cache/") + FileName).string();
+}
+
+bool ProgramCacheEnabled(){
+    static bool Supported = ProgramBinarySupported();
+    return Supported;
+}
+
+GLuint LoadCachedProgram(const std::string& vertex_file_path, const std::string& fragment_file_path,
+                         const std::string& vertex_code, const std::string& fragment_code){
+    if (!ProgramCacheEnabled()) {
+        return 0;
+    }
+
+    GLuint ProgramID = LoadProgramBinary(ProgramCachePath(vertex_file_path, fragment_file_path), ProgramCacheKey(vertex_code, fragment_code));
+    if (ProgramID != 0) {
+        BindUniformBlocks(ProgramID);
+        CacheStats.m_hits++;
+        std::clog << "Loaded program from cache : " << vertex_file_path << ", " << fragment_file_path << "\n";
+    } else {
+        CacheStats.m_misses++;
+    }
+    return ProgramID;
+}
+
+void SaveCachedProgram(const std::string& vertex_file_path, const std::string& fragment_file_path,
+                       const std::string& vertex_code, const std::string& fragment_code, GLuint program_id){
+    if (ProgramCacheEnabled()) {
+        SaveProgramBinary(ProgramCachePath(vertex_file_path, fragment_file_path), ProgramCacheKey(vertex_code, fragment_code), program_id);
+    }
+}
+
 GLuint LoadShaders(const std::string& vertex_file_path, const std::string& fragment_file_path){
-    GLuint VertexShaderID = CompileShader(vertex_file_path, GL_VERTEX_SHADER);
-    GLuint FragmentShaderID = CompileShader(fragment_file_path, GL_FRAGMENT_SHADER);
+    std::string VertexShaderCode = ReadShaderSource(vertex_file_path);
+    std::string FragmentShaderCode = ReadShaderSource(fragment_file_path);
+
+    GLuint CachedProgramID = LoadCachedProgram(vertex_file_path, fragment_file_path, VertexShaderCode, FragmentShaderCode);
+    if (CachedProgramID != 0) {
+        return CachedProgramID;
+    }
+
+    GLuint VertexShaderID = CompileShaderSource(VertexShaderCode, vertex_file_path, GL_VERTEX_SHADER);
+    GLuint FragmentShaderID = CompileShaderSource(FragmentShaderCode, fragment_file_path, GL_FRAGMENT_SHADER);
 
     GLint Result = GL_FALSE;
     int InfoLogLength;
@@ -67,6 +231,9 @@ GLuint LoadShaders(const std::string& vertex_file_path, const std::string& fragm
     GLuint ProgramID = glCreateProgram();
     glAttachShader(ProgramID, VertexShaderID);
     glAttachShader(ProgramID, FragmentShaderID);
+    if (ProgramCacheEnabled()) {
+        glProgramParameteri(ProgramID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glLinkProgram(ProgramID);
 
     //Error Check
@@ -78,6 +245,11 @@ GLuint LoadShaders(const std::string& vertex_file_path, const std::string& fragm
         std::cerr << &ProgramErrorMessage[0] << "\n";
     }
 
+    if (Result == GL_TRUE) {
+        BindUniformBlocks(ProgramID);
+        SaveCachedProgram(vertex_file_path, fragment_file_path, VertexShaderCode, FragmentShaderCode, ProgramID);
+    }
+
     //Cleanup
     glDetachShader(ProgramID, VertexShaderID);
     glDetachShader(ProgramID, FragmentShaderID);
@@ -88,3 +260,56 @@ GLuint LoadShaders(const std::string& vertex_file_path, const std::string& fragm
     std::clog << "Done loading shaders\n";
     return ProgramID;
 }
+
+GLuint LoadComputeShader(const std::string& compute_file_path){
+    GLuint ComputeShaderID = CompileShader(compute_file_path, GL_COMPUTE_SHADER);
+
+    GLint Result = GL_FALSE;
+    int InfoLogLength;
+
+    //Link Shader
+    std::clog << "Linking compute program\n";
+    GLuint ProgramID = glCreateProgram();
+    glAttachShader(ProgramID, ComputeShaderID);
+    glLinkProgram(ProgramID);
+
+    //Error Check
+    glGetProgramiv(ProgramID, GL_LINK_STATUS, &Result);
+    glGetProgramiv(ProgramID, GL_INFO_LOG_LENGTH, &InfoLogLength);
+    if (InfoLogLength > 0) {
+        std::vector<char> ProgramErrorMessage(InfoLogLength + 1);
+        glGetProgramInfoLog(ProgramID, InfoLogLength, NULL, &ProgramErrorMessage[0]);
+        std::cerr << &ProgramErrorMessage[0] << "\n";
+    }
+
+    //Cleanup
+    glDetachShader(ProgramID, ComputeShaderID);
+    glDeleteShader(ComputeShaderID);
+
+    if (Result != GL_TRUE) {
+        glDeleteProgram(ProgramID);
+        return 0;
+    }
+    return ProgramID;
+}
+
+void BindUniformBlocks(GLuint program_id){
+    const char* names[2] = {"CameraBlock", "DrawBlock"};
+    const GLuint bindings[2] = {UniformBuffers::CAMERA_BINDING, UniformBuffers::DRAW_BINDING};
+    for (int i = 0; i < 2; i++) {
+        GLuint index = glGetUniformBlockIndex(program_id, names[i]);
+        if (index != GL_INVALID_INDEX) {
+            glUniformBlockBinding(program_id, index, bindings[i]);
+        }
+    }
+    if (GLEW_ARB_shader_storage_buffer_object) {
+        GLuint index = glGetProgramResourceIndex(program_id, GL_SHADER_STORAGE_BLOCK, "TransformBlock");
+        if (index != GL_INVALID_INDEX) {
+            glShaderStorageBlockBinding(program_id, index, IndirectRenderer::TRANSFORM_BINDING);
+        }
+    }
+}
+
+ShaderCacheStats GetShaderCacheStats(){
+    return CacheStats;
+}
@@ -7,7 +7,44 @@
 #define GLEW_STATIC
 #include <GL/glew.h>
 
+/// Number of programs `LoadShaders` loaded from the program binary
+/// cache and the number it had to compile from source.
+struct ShaderCacheStats {
+    unsigned int m_hits;
+    unsigned int m_misses;
+};
+
+std::string ReadShaderSource(const std::string& shader_file_path);
+GLuint CompileShaderSource(const std::string& shader_code, const std::string& shader_name, GLenum shader_type);
 GLuint CompileShader(const std::string& shader_file_path, GLenum shader_type);
+/// Builds a program from a vertex and a fragment shader. When the driver
+/// supports program binaries the linked program is cached in
+/// `shader_cache/` next to the executable, keyed by the shader sources
+/// and the driver's vendor, renderer and version strings. A missing,
+/// stale or rejected binary falls back to compiling from source.
 GLuint LoadShaders(const std::string& vertex_file_path, const std::string& fragment_file_path);
+/// Builds a program from a compute shader, needs `ARB_compute_shader`.
+/// Compute programs are not cached and have no blocks bound, their users
+/// bind the blocks they need.
+/// @return The linked program, or 0 if it failed to link.
+GLuint LoadComputeShader(const std::string& compute_file_path);
+ShaderCacheStats GetShaderCacheStats();
+/// Binds the `CameraBlock` and `DrawBlock` uniform blocks of a program to
+/// the binding points of `UniformBuffers`, and the `TransformBlock`
+/// storage block to that of `IndirectRenderer`, so that every program
+/// reads the same buffers. Blocks the program does not use are skipped.
+/// `LoadShaders` and `LoadCachedProgram` do this for the programs they return.
+void BindUniformBlocks(GLuint program_id);
+
+/// @return True if the driver supports program binaries.
+bool ProgramCacheEnabled();
+/// Loads a program from the program binary cache, see `LoadShaders`.
+/// @return The linked program, or 0 if there is no valid cached binary.
+GLuint LoadCachedProgram(const std::string& vertex_file_path, const std::string& fragment_file_path,
+                         const std::string& vertex_code, const std::string& fragment_code);
+/// Writes a linked program to the program binary cache. The program
+/// should be linked with `GL_PROGRAM_BINARY_RETRIEVABLE_HINT` set.
+void SaveCachedProgram(const std::string& vertex_file_path, const std::string& fragment_file_path,
+                       const std::string& vertex_code, const std::string& fragment_code, GLuint program_id);
 
 #endif
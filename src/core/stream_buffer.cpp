@@ -0,0 +1,108 @@
+#include "core/stream_buffer.h"
+
+#include <iostream>
+
+StreamBuffer::StreamBuffer(GLenum target, GLsizeiptr regionSize, unsigned int regionCount) {
+    m_target = target;
+    m_regionSize = regionSize;
+    m_regionCount = regionCount;
+    m_currentRegion = regionCount - 1;
+    m_mapped = nullptr;
+    m_fences.assign(regionCount, nullptr);
+
+    GLsizeiptr size = regionSize*regionCount;
+    m_buffer = GLBuffer::create();
+    glBindBuffer(m_target, m_buffer.get());
+    if (GLEW_ARB_buffer_storage) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(m_target, size, NULL, flags);
+        m_mapped = static_cast<unsigned char*>(glMapBufferRange(m_target, 0, size, flags));
+        if (m_mapped == nullptr) {
+            // immutable storage can not be resized or written with
+            // glBufferSubData, so the fallback needs a new buffer
+            std::cerr << "Failed to map stream buffer of " << size << " bytes, using glBufferSubData" << std::endl;
+            m_buffer = GLBuffer::create();
+            glBindBuffer(m_target, m_buffer.get());
+        }
+    }
+    if (m_mapped == nullptr) {
+        glBufferData(m_target, size, NULL, GL_STREAM_DRAW);
+        m_staging.resize(static_cast<size_t>(regionSize));
+    }
+}
+
+void StreamBuffer::releaseBuffers() {
+    for (GLsync& fence : m_fences) {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    if (m_mapped != nullptr) {
+        glBindBuffer(m_target, m_buffer.get());
+        glUnmapBuffer(m_target);
+        m_mapped = nullptr;
+    }
+    m_buffer.reset();
+}
+
+void StreamBuffer::waitForRegion(unsigned int region) {
+    GLsync& fence = m_fences[region];
+    if (fence == nullptr) {
+        return;
+    }
+
+    // the first wait flushes the command stream so the fence is
+    // guaranteed to signal, later waits only poll
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (true) {
+        GLenum result = glClientWaitSync(fence, flags, 1000000);
+        if ((result == GL_ALREADY_SIGNALED) || (result == GL_CONDITION_SATISFIED) || (result == GL_WAIT_FAILED)) {
+            break;
+        }
+        flags = 0;
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void* StreamBuffer::beginWrite() {
+    m_currentRegion = (m_currentRegion + 1) % m_regionCount;
+    waitForRegion(m_currentRegion);
+
+    if (m_mapped != nullptr) {
+        return m_mapped + getRegionOffset();
+    }
+    return m_staging.data();
+}
+
+void StreamBuffer::endWrite() {
+    endWrite(0, m_regionSize);
+}
+
+void StreamBuffer::endWrite(GLintptr offset, GLsizeiptr size) {
+    // coherent persistent mappings need no flush
+    if ((m_mapped == nullptr) && (size > 0)) {
+        glBindBuffer(m_target, m_buffer.get());
+        glBufferSubData(m_target, getRegionOffset() + offset, size, m_staging.data() + offset);
+    }
+}
+
+void StreamBuffer::lockRegion() {
+    if (m_fences[m_currentRegion] != nullptr) {
+        glDeleteSync(m_fences[m_currentRegion]);
+    }
+    m_fences[m_currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+GLuint StreamBuffer::getBuffer() const {
+    return m_buffer.get();
+}
+
+GLsizeiptr StreamBuffer::getRegionSize() const {
+    return m_regionSize;
+}
+
+GLintptr StreamBuffer::getRegionOffset() const {
+    return static_cast<GLintptr>(m_currentRegion)*m_regionSize;
+}
@@ -0,0 +1,65 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <vector>
+
+// keep this before all other OpenGL libraries
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+#include "core/gl_object.h"
+
+/// A buffer for data that is rewritten every frame. The buffer is split
+/// into a ring of regions and every frame writes to the next region
+/// while the GPU may still be reading the previous ones. The buffer is
+/// allocated once with `glBufferStorage` and stays persistently mapped,
+/// and a fence per region keeps the CPU from overwriting data that is
+/// still in use. Without `ARB_buffer_storage` the regions are filled
+/// through `glBufferSubData` from a CPU side copy instead, and so are
+/// they when the persistent mapping fails.
+///
+/// Each frame should call `beginWrite()`, fill the region, call
+/// `endWrite()`, issue the draws that read the region and finally call
+/// `lockRegion()`.
+class StreamBuffer {
+private:
+    GLBuffer m_buffer;
+    GLenum m_target;
+    GLsizeiptr m_regionSize;
+    unsigned int m_regionCount;
+    unsigned int m_currentRegion;
+    unsigned char* m_mapped;
+    std::vector<unsigned char> m_staging;
+    std::vector<GLsync> m_fences;
+
+    /// Blocks until the GPU is done with the given region.
+    void waitForRegion(unsigned int region);
+public:
+    /// @param target Buffer target the data is used as, for example
+    /// `GL_ARRAY_BUFFER`.
+    /// @param regionSize Size in bytes of the data written each frame.
+    /// @param regionCount Number of frames that can be in flight.
+    StreamBuffer(GLenum target, GLsizeiptr regionSize, unsigned int regionCount=3);
+    void releaseBuffers();
+
+    /// Moves to the next region and waits until it is safe to write.
+    /// @return Pointer to the region, valid until `endWrite()`. Never
+    /// null.
+    void* beginWrite();
+    /// Makes the data written since `beginWrite()` visible to the GPU.
+    void endWrite();
+    /// Makes part of the region visible to the GPU, for regions that are
+    /// only partly filled or filled in several steps.
+    /// @param offset Offset in bytes from the start of the region.
+    /// @param size Number of bytes to make visible.
+    void endWrite(GLintptr offset, GLsizeiptr size);
+    /// Fences the current region after the draw calls that read it.
+    void lockRegion();
+
+    GLuint getBuffer() const;
+    GLsizeiptr getRegionSize() const;
+    /// @return Offset in bytes of the current region within the buffer.
+    GLintptr getRegionOffset() const;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#include "core/uniform_buffers.h"
+
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+#include "core/render_stats.h"
+
+GLsizeiptr UniformBuffers::alignedSize(size_t size) {
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    size_t step = static_cast<size_t>(alignment);
+    return static_cast<GLsizeiptr>((size + step - 1)/step*step);
+}
+
+UniformBuffers::UniformBuffers(size_t maxDraws) :
+    m_cameraStride(alignedSize(sizeof(CameraBlock))),
+    m_drawStride(alignedSize(sizeof(DrawBlock))),
+    m_maxDraws(maxDraws),
+    m_cameraBuffer(GL_UNIFORM_BUFFER, m_cameraStride),
+    m_drawBuffer(GL_UNIFORM_BUFFER, m_drawStride*static_cast<GLsizeiptr>(maxDraws)) {
+    m_draws = nullptr;
+    m_drawCount = 0;
+    m_flushedCount = 0;
+}
+
+void UniformBuffers::releaseBuffers() {
+    m_cameraBuffer.releaseBuffers();
+    m_drawBuffer.releaseBuffers();
+}
+
+void UniformBuffers::setCamera(const CameraBlock& camera) {
+    std::memcpy(m_cameraBuffer.beginWrite(), &camera, sizeof(CameraBlock));
+    m_cameraBuffer.endWrite(0, sizeof(CameraBlock));
+    glBindBufferRange(GL_UNIFORM_BUFFER, CAMERA_BINDING, m_cameraBuffer.getBuffer(), m_cameraBuffer.getRegionOffset(), sizeof(CameraBlock));
+    RenderStats::getInstance()->m_bindCalls++;
+}
+
+size_t UniformBuffers::addDraw(const DrawBlock& draw) {
+    if (m_draws == nullptr) {
+        m_draws = static_cast<unsigned char*>(m_drawBuffer.beginWrite());
+    }
+    if (m_drawCount == m_maxDraws) {
+        growDraws();
+    }
+    size_t index = m_drawCount++;
+    std::memcpy(m_draws + static_cast<size_t>(m_drawStride)*index, &draw, sizeof(DrawBlock));
+    return index;
+}
+
+void UniformBuffers::growDraws() {
+    flush();
+    size_t max_draws = 2*m_maxDraws;
+    std::clog << "Growing the draw blocks from " << m_maxDraws << " to " << max_draws << " per frame\n";
+    StreamBuffer draw_buffer = StreamBuffer(GL_UNIFORM_BUFFER, m_drawStride*static_cast<GLsizeiptr>(max_draws));
+    unsigned char* draws = static_cast<unsigned char*>(draw_buffer.beginWrite());
+
+    glBindBuffer(GL_COPY_READ_BUFFER, m_drawBuffer.getBuffer());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, draw_buffer.getBuffer());
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, m_drawBuffer.getRegionOffset(),
+                        draw_buffer.getRegionOffset(), m_drawStride*static_cast<GLsizeiptr>(m_drawCount));
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    m_drawBuffer.releaseBuffers();
+    m_drawBuffer = std::move(draw_buffer);
+    m_draws = draws;
+    m_maxDraws = max_draws;
+}
+
+void UniformBuffers::flush() {
+    if (m_flushedCount == m_drawCount) {
+        return;
+    }
+    GLintptr offset = m_drawStride*static_cast<GLintptr>(m_flushedCount);
+    m_drawBuffer.endWrite(offset, m_drawStride*static_cast<GLsizeiptr>(m_drawCount) - offset);
+    m_flushedCount = m_drawCount;
+}
+
+void UniformBuffers::bindDraw(size_t index) {
+    GLintptr offset = m_drawBuffer.getRegionOffset() + m_drawStride*static_cast<GLintptr>(index);
+    glBindBufferRange(GL_UNIFORM_BUFFER, DRAW_BINDING, m_drawBuffer.getBuffer(), offset, sizeof(DrawBlock));
+    RenderStats::getInstance()->m_bindCalls++;
+}
+
+void UniformBuffers::lockRegions() {
+    m_cameraBuffer.lockRegion();
+    if (m_draws != nullptr) {
+        m_drawBuffer.lockRegion();
+    }
+    m_draws = nullptr;
+    m_drawCount = 0;
+    m_flushedCount = 0;
+}
@@ -0,0 +1,84 @@
+#ifndef UNIFORM_BUFFERS_H
+#define UNIFORM_BUFFERS_H
+
+// keep this before all other OpenGL libraries
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "core/stream_buffer.h"
+
+/// The `CameraBlock` uniform block in std140 layout, written once per frame.
+struct CameraBlock {
+    glm::mat4 m_viewProjection;
+    glm::mat4 m_view;
+    glm::mat4 m_projection;
+    /// Camera position in world space, w is 1.
+    glm::vec4 m_position;
+};
+
+/// The `DrawBlock` uniform block in std140 layout, written once per draw.
+struct DrawBlock {
+    glm::mat4 m_modelSpaceToWorldSpace;
+    /// Nonzero to use the per-instance transform attribute instead.
+    GLint m_instanced;
+    GLint m_padding[3];
+};
+
+static_assert(sizeof(CameraBlock) == 208, "CameraBlock must match the std140 layout");
+static_assert(sizeof(DrawBlock) == 80, "DrawBlock must match the std140 layout");
+
+/// The uniform buffers shared by every program, see `BindUniformBlocks()`.
+/// The camera block is bound once per frame and stays bound when the
+/// program changes. The draw blocks of a frame are packed into one ring
+/// buffer region and each draw only binds its range of the region, so
+/// draws make no uniform calls. A frame with more draws than the ring
+/// has room for doubles its size.
+///
+/// Each frame should call `setCamera()`, then `addDraw()`, `flush()` and
+/// `bindDraw()` for the draws, and finally `lockRegions()` after the
+/// draws have been issued.
+class UniformBuffers {
+public:
+    static constexpr GLuint CAMERA_BINDING = 0;
+    static constexpr GLuint DRAW_BINDING = 1;
+private:
+    /// Size of each block rounded up to `GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT`.
+    GLsizeiptr m_cameraStride;
+    GLsizeiptr m_drawStride;
+    size_t m_maxDraws;
+    StreamBuffer m_cameraBuffer;
+    StreamBuffer m_drawBuffer;
+    /// Region of `m_drawBuffer` of the current frame, null until the
+    /// first draw of the frame is added.
+    unsigned char* m_draws;
+    size_t m_drawCount;
+    /// Number of draws already made visible to the GPU.
+    size_t m_flushedCount;
+
+    static GLsizeiptr alignedSize(size_t size);
+    /// Replaces the draw ring with one of twice the size. The blocks
+    /// already added this frame are copied over on the GPU so their
+    /// indices stay valid, and the draws already issued keep reading the
+    /// old buffer until the driver frees it.
+    void growDraws();
+public:
+    /// @param maxDraws Number of draw blocks each frame has room for
+    /// before the ring grows.
+    UniformBuffers(size_t maxDraws=4096);
+    void releaseBuffers();
+
+    /// Writes the camera block of the frame and binds it.
+    void setCamera(const CameraBlock& camera);
+    /// Adds a draw block to the frame, growing the ring if it is full.
+    /// @return Index of the block, to be bound with `bindDraw()`.
+    size_t addDraw(const DrawBlock& draw);
+    /// Makes the draw blocks added since the last flush visible to the GPU.
+    void flush();
+    /// Binds a flushed draw block to `DRAW_BINDING`.
+    void bindDraw(size_t index);
+    /// Fences the regions of the frame after its last draw.
+    void lockRegions();
+};
+
+#endif
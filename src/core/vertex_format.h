@@ -0,0 +1,61 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <cstdint>
+
+// keep this before all other OpenGL libraries
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+/// Maps a C++ type to the matching OpenGL type enum.
+template<typename T> struct GLType;
+template<> struct GLType<GLfloat> { static constexpr GLenum value = GL_FLOAT; };
+template<> struct GLType<GLubyte> { static constexpr GLenum value = GL_UNSIGNED_BYTE; };
+template<> struct GLType<GLushort> { static constexpr GLenum value = GL_UNSIGNED_SHORT; };
+
+/// A vertex attribute made of `Components` values of type `T`.
+template<typename T, GLint Components, GLboolean Normalized = GL_FALSE>
+struct VertexAttribute {
+    static constexpr GLint components = Components;
+    static constexpr GLenum type = GLType<T>::value;
+    static constexpr GLboolean normalized = Normalized;
+    static constexpr GLsizei size = static_cast<GLsizei>(Components*sizeof(T));
+};
+
+/// A compile time description of an interleaved vertex layout. The
+/// attributes are stored one after another in each vertex and are bound
+/// to consecutive attribute locations starting at 0, in the order they
+/// are listed.
+template<typename... Attributes>
+struct VertexFormat {
+    static constexpr GLuint attributeCount = sizeof...(Attributes);
+    static constexpr GLsizei stride = (Attributes::size + ...);
+
+    /// Sets up the attributes of the bound vertex array to read from the
+    /// buffer bound to `GL_ARRAY_BUFFER`.
+    static void setAttributes() {
+        GLuint location = 0;
+        std::uintptr_t offset = 0;
+        (setAttribute<Attributes>(location, offset), ...);
+    }
+private:
+    template<typename Attribute>
+    static void setAttribute(GLuint& location, std::uintptr_t& offset) {
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, Attribute::components, Attribute::type, Attribute::normalized, stride, reinterpret_cast<void*>(offset));
+        location++;
+        offset += static_cast<std::uintptr_t>(Attribute::size);
+    }
+};
+
+using PositionAttribute = VertexAttribute<GLfloat, 3>;
+using ColorAttribute = VertexAttribute<GLfloat, 3>;
+using NormalAttribute = VertexAttribute<GLfloat, 3>;
+using UVAttribute = VertexAttribute<GLfloat, 2>;
+
+/// Position and color, the layout used by the parametric meshes.
+using PositionColorFormat = VertexFormat<PositionAttribute, ColorAttribute>;
+/// Position, color, normal and texture coordinates.
+using PositionColorNormalUVFormat = VertexFormat<PositionAttribute, ColorAttribute, NormalAttribute, UVAttribute>;
+
+#endif
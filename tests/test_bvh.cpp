@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+
+#include "core/bounds.h"
+#include "core/bvh.h"
+#include "core/frustum.h"
+#include "test_util.h"
+
+constexpr int num_frames = 200;
+
+/// Scatters boxes of different sizes through a cube around the origin.
+static std::vector<Bounds> scatterBounds(size_t count, float size, std::mt19937& random) {
+    std::uniform_real_distribution<float> position(-size, size);
+    std::uniform_real_distribution<float> extent(0.05f, 2.f);
+    std::vector<Bounds> bounds(count);
+    for (Bounds& object : bounds) {
+        BoundingBox box;
+        box.m_min = glm::vec3(position(random), position(random), position(random));
+        box.m_max = box.m_min + glm::vec3(extent(random), extent(random), extent(random));
+        object = boundsFromBox(box);
+    }
+    return bounds;
+}
+
+/// Moves every box along its own direction, so over the frames the
+/// hierarchy is refitted and eventually rebuilt.
+static void moveBounds(std::vector<Bounds>& bounds, int frame) {
+    for (size_t i = 0; i < bounds.size(); i++) {
+        float phase = static_cast<float>(i);
+        glm::vec3 offset = 0.05f*glm::vec3(std::sin(phase), std::cos(1.7f*phase), std::sin(0.3f*phase + 0.01f*static_cast<float>(frame)));
+        BoundingBox box = bounds[i].m_box;
+        box.m_min += offset;
+        box.m_max += offset;
+        bounds[i] = boundsFromBox(box);
+    }
+}
+
+/// A camera circling the origin and looking at a point near it.
+static Frustum orbitFrustum(int frame, float radius) {
+    float angle = 0.05f*static_cast<float>(frame);
+    glm::vec3 eye = glm::vec3(radius*std::cos(angle), 0.3f*radius*std::sin(0.7f*angle), radius*std::sin(angle));
+    glm::vec3 target = glm::vec3(0.2f*radius*std::sin(1.3f*angle), 0.f, 0.f);
+    glm::mat4 view = glm::lookAt(eye, target, glm::vec3(0.f, 1.f, 0.f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.f), 16.f/9.f, 0.1f, 2.f*radius);
+    return Frustum(projection*view);
+}
+
+/// Tests every object with the same tests as the leaves of the hierarchy.
+static std::vector<std::uint32_t> bruteForceCull(const Frustum& frustum, const std::vector<Bounds>& bounds) {
+    std::vector<std::uint32_t> visible;
+    for (size_t i = 0; i < bounds.size(); i++) {
+        if (frustum.intersects(bounds[i].m_sphere) && (frustum.classify(bounds[i].m_box) != Frustum::OUTSIDE)) {
+            visible.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    return visible;
+}
+
+/// Culls a moving scene every frame with the hierarchy and by testing
+/// every object, the visible sets must be the same.
+static void checkScene(size_t count, float size, std::mt19937& random) {
+    std::vector<Bounds> bounds = scatterBounds(count, size, random);
+    BoundingVolumeHierarchy bvh = BoundingVolumeHierarchy();
+    std::vector<std::uint32_t> visible;
+    size_t mismatches = 0, total_visible = 0;
+    for (int frame = 0; frame < num_frames; frame++) {
+        moveBounds(bounds, frame);
+        bvh.update(bounds);
+        Frustum frustum = orbitFrustum(frame, 1.5f*size);
+
+        bvh.cull(frustum, visible);
+        std::sort(visible.begin(), visible.end());
+        std::vector<std::uint32_t> expected = bruteForceCull(frustum, bounds);
+        mismatches += (visible != expected);
+        total_visible += expected.size();
+    }
+
+    std::clog << count << " objects: " << mismatches << " of " << num_frames << " frames differ, "
+              << total_visible/num_frames << " visible per frame, " << bvh.m_rebuilds << " rebuilds and "
+              << bvh.m_refits << " refits\n";
+    CHECK(mismatches == 0);
+    CHECK(bvh.size() == count);
+    if (count > BoundingVolumeHierarchy::LEAF_SIZE) {
+        // the scene should be partly visible, and the moving objects
+        // should have exercised both refitting and rebuilding
+        CHECK(total_visible > 0);
+        CHECK(total_visible < count*num_frames);
+        CHECK(bvh.m_refits > 0);
+        CHECK(bvh.m_rebuilds > 1);
+    }
+}
+
+int main() {
+    std::mt19937 random(12345);
+
+    BoundingVolumeHierarchy empty = BoundingVolumeHierarchy();
+    std::vector<std::uint32_t> visible = {1, 2, 3};
+    empty.update(std::vector<Bounds>());
+    empty.cull(orbitFrustum(0, 10.f), visible);
+    CHECK(visible.empty());
+
+    checkScene(1, 10.f, random);
+    checkScene(BoundingVolumeHierarchy::LEAF_SIZE, 10.f, random);
+    checkScene(BoundingVolumeHierarchy::LEAF_SIZE + 1, 10.f, random);
+    checkScene(1000, 30.f, random);
+    checkScene(10000, 100.f, random);
+    return testResult();
+}
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// keep this before all other OpenGL libraries
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "core/compute_integrator.h"
+#include "core/headless_context.h"
+#include "core/physics_world.h"
+#include "test_util.h"
+
+/// Not a multiple of `ComputeIntegrator::WORK_GROUP_SIZE`, so the last
+/// work group is only partly used.
+constexpr size_t num_bodies = 10007;
+constexpr int num_frames = 600;
+constexpr float timestep = 1.f/120.f;
+/// Largest difference allowed between the GPU and the CPU in any
+/// component. GLSL rounds additions and multiplications correctly and
+/// the shader marks its state `precise`, so the steps round exactly like
+/// `PhysicsWorld::step`. Any difference would also grow over the frames,
+/// in the worst case flipping a floor bounce.
+constexpr std::int64_t max_ulp = 0;
+
+/// Fills a world with bodies thrown up and down from around the floor,
+/// so most of them bounce several times during the run.
+static void initalizeBodies(PhysicsWorld& world) {
+    for (size_t i = 0; i < num_bodies; i++) {
+        float phase = static_cast<float>(i);
+        glm::vec3 position = glm::vec3(std::sin(phase), 2.f*std::cos(0.37f*phase), 0.01f*phase);
+        glm::vec3 velocity = glm::vec3(0.3f*std::cos(phase), 8.f*std::sin(1.3f*phase), 0.5f);
+        glm::vec3 acceleration = glm::vec3(0.1f*std::sin(0.5f*phase), -9.81f, 0.f);
+        world.addBody(position, velocity, acceleration);
+    }
+}
+
+static std::int64_t ulpDistance(glm::vec3 a, glm::vec3 b) {
+    return std::max(ulpDistance(a.x, b.x), std::max(ulpDistance(a.y, b.y), ulpDistance(a.z, b.z)));
+}
+
+/// @param argv The path of `integrate_compute.glsl`.
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " integrate_compute.glsl\n";
+        return 1;
+    }
+
+    HeadlessContext context = HeadlessContext();
+    if (!context.create(64, 64)) {
+        std::clog << "No OpenGL context, skipping\n";
+        return SKIP_TEST;
+    }
+    // the headless context has a core profile, which GLEW only fully
+    // loads in experimental mode
+    glewExperimental = GL_TRUE;
+    GLenum glew_status = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // GLEW built for GLX finds no X display when the context comes from
+    // EGL, the core OpenGL functions are loaded regardless
+    if (glew_status == GLEW_ERROR_NO_GLX_DISPLAY) {
+        glew_status = GLEW_OK;
+    }
+#endif
+    if ((glew_status != GLEW_OK) || !ComputeIntegrator::isSupported()) {
+        std::clog << "Compute shaders are not supported, skipping\n";
+        context.release();
+        return SKIP_TEST;
+    }
+
+    ComputeIntegrator integrator = ComputeIntegrator();
+    PhysicsWorld cpu = PhysicsWorld();
+    initalizeBodies(cpu);
+    if (!CHECK(integrator.load(argv[1])) || !CHECK(integrator.upload(cpu))) {
+        integrator.releaseBuffers();
+        context.release();
+        return testResult();
+    }
+    CHECK(integrator.size() == num_bodies);
+
+    // a varying number of steps per frame like the fixed step scheduler
+    // gives, including frames without a step
+    std::vector<float> velocities;
+    size_t bounces = 0;
+    for (int frame = 0; frame < num_frames; frame++) {
+        unsigned int steps = static_cast<unsigned int>(frame%4);
+        for (unsigned int step = 0; step < steps; step++) {
+            velocities.assign(cpu.m_velocityY.begin(), cpu.m_velocityY.end());
+            cpu.step(timestep);
+            for (size_t i = 0; i < num_bodies; i++) {
+                bounces += (cpu.m_velocityY[i]*velocities[i] < 0.f) && (cpu.m_positionY[i] < 0.f);
+            }
+        }
+        integrator.update(timestep, steps, 0.5f);
+    }
+
+    PhysicsWorld gpu = cpu;
+    // anything the download misses stays NaN and fails the comparison
+    for (size_t i = 0; i < num_bodies; i++) {
+        gpu.m_positionX[i] = gpu.m_positionY[i] = gpu.m_positionZ[i] = NAN;
+        gpu.m_velocityX[i] = gpu.m_velocityY[i] = gpu.m_velocityZ[i] = NAN;
+    }
+    integrator.download(gpu);
+    CHECK(glGetError() == GL_NO_ERROR);
+
+    size_t mismatches = 0;
+    std::int64_t worst = 0;
+    for (size_t i = 0; i < num_bodies; i++) {
+        std::int64_t ulp = std::max(ulpDistance(gpu.getPosition(i), cpu.getPosition(i)),
+                                    ulpDistance(gpu.getVelocity(i), cpu.getVelocity(i)));
+        worst = std::max(worst, ulp);
+        mismatches += (ulp > max_ulp);
+    }
+    std::clog << mismatches << " of " << num_bodies << " bodies differ by more than " << max_ulp
+              << " ulp after " << num_frames << " frames with " << bounces << " floor bounces, at most "
+              << worst << " ulp\n";
+    CHECK(mismatches == 0);
+    CHECK(bounces > num_bodies);
+
+    integrator.releaseBuffers();
+    context.release();
+    return testResult();
+}
@@ -0,0 +1,97 @@
+#include <cstdint>
+
+// keep this before all other OpenGL libraries
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+#include "core/gpu_timer.h"
+#include "core/headless_context.h"
+#include "test_util.h"
+
+constexpr int num_frames = 200;
+/// More than `GpuTimer` keeps in flight, so results must be read or
+/// dropped while the frames are still being submitted.
+constexpr std::uint64_t max_in_flight = 8;
+
+/// Clears the framebuffer a few times, the pass being timed.
+static void clearPass(int frame) {
+    for (int i = 0; i < 4; i++) {
+        glClearColor(0.01f*static_cast<float>(frame % 100), 0.1f*static_cast<float>(i), 0.f, 1.f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+}
+
+/// @return True if a time read from the timestamp queries is plausible,
+/// a pair of timestamps in the wrong order would wrap around to a huge
+/// time.
+static bool isValidTime(double seconds) {
+    return (seconds >= 0.0) && (seconds < 10.0);
+}
+
+int main() {
+    HeadlessContext context = HeadlessContext();
+    if (!context.create(256, 256)) {
+        std::clog << "No OpenGL context, skipping\n";
+        return SKIP_TEST;
+    }
+    // the headless context has a core profile, which GLEW only fully
+    // loads in experimental mode
+    glewExperimental = GL_TRUE;
+    GLenum glew_status = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // GLEW built for GLX finds no X display when the context comes from
+    // EGL, the core OpenGL functions are loaded regardless
+    if (glew_status == GLEW_ERROR_NO_GLX_DISPLAY) {
+        glew_status = GLEW_OK;
+    }
+#endif
+    if ((glew_status != GLEW_OK) || !context.createFramebuffer()) {
+        std::clog << "Failed to set up the offscreen framebuffer, skipping\n";
+        context.release();
+        return SKIP_TEST;
+    }
+
+    GpuTimer timer = GpuTimer();
+    CHECK(timer.getCollectedCount() == 0);
+    CHECK(timer.getLastPassTime("Clear") < 0.0);
+
+    // frames are submitted back to back without ever waiting on the GPU,
+    // like a render loop that only flushes at the swap
+    size_t invalid_times = 0;
+    std::uint64_t collected = 0;
+    for (int frame = 0; frame < num_frames; frame++) {
+        timer.beginFrame();
+        if (timer.getCollectedCount() != collected) {
+            collected = timer.getCollectedCount();
+            double frame_time = timer.getLastFrameTime(), pass_time = timer.getLastPassTime("Clear");
+            invalid_times += !isValidTime(frame_time) || !isValidTime(pass_time) || (pass_time > frame_time);
+        }
+        timer.beginPass("Clear");
+        clearPass(frame);
+        timer.endPass();
+        timer.endFrame();
+        glFlush();
+    }
+
+    // the results were read while polling, and every frame but the few
+    // still in flight was either read or counted as dropped
+    std::uint64_t dropped = timer.getDroppedCount();
+    std::clog << collected << " of " << num_frames << " frames read while rendering, " << dropped << " dropped, last frame "
+              << 1e3*timer.getLastFrameTime() << " ms on the GPU\n";
+    CHECK(collected > 0);
+    CHECK(collected + dropped + max_in_flight >= static_cast<std::uint64_t>(num_frames));
+    CHECK(invalid_times == 0);
+
+    // once the GPU is idle the next frame reads every frame left
+    glFinish();
+    timer.beginFrame();
+    CHECK(timer.getCollectedCount() + timer.getDroppedCount() == static_cast<std::uint64_t>(num_frames));
+    CHECK(isValidTime(timer.getLastFrameTime()));
+    CHECK(isValidTime(timer.getLastPassTime("Clear")));
+    timer.endFrame();
+    CHECK(glGetError() == GL_NO_ERROR);
+
+    timer.releaseQueries();
+    context.release();
+    return testResult();
+}
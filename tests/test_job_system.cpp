@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+#include <thread>
+#include <vector>
+
+#include "core/job_system.h"
+#include "test_util.h"
+
+/// Runs a loop and checks that every index is visited exactly once, in
+/// ranges that start on a chunk boundary and are no longer than a chunk.
+static void checkCoverage(JobSystem& jobs, size_t count, size_t chunkSize) {
+    std::vector<std::atomic<int>> visits(count);
+    std::atomic<size_t> bad_ranges(0);
+    jobs.parallelFor(count, chunkSize, [&](size_t begin, size_t end) {
+        if ((begin >= end) || (end > count) || (end - begin > chunkSize) || (begin % chunkSize != 0)) {
+            bad_ranges++;
+            return;
+        }
+        for (size_t i = begin; i < end; i++) {
+            visits[i]++;
+        }
+    });
+
+    size_t wrong = 0;
+    for (const std::atomic<int>& visit : visits) {
+        wrong += (visit.load() != 1);
+    }
+    if ((wrong > 0) || (bad_ranges > 0)) {
+        std::cerr << jobs.threadCount() << " threads, " << count << " elements in chunks of " << chunkSize << ": "
+                  << wrong << " elements not visited once, " << bad_ranges << " bad ranges\n";
+    }
+    CHECK(wrong == 0);
+    CHECK(bad_ranges == 0);
+}
+
+/// Makes the chunks slow and uneven so the workers run out of their own
+/// chunks and steal, then checks that every chunk, wherever it ran, had
+/// finished and its plain writes are visible once `parallelFor()`
+/// returns.
+static void checkStolenChunks(JobSystem& jobs) {
+    constexpr size_t count = 64;
+    std::vector<int> results(count, 0);
+    std::vector<std::thread::id> threads(count);
+    for (int run = 0; run < 10; run++) {
+        std::fill(results.begin(), results.end(), 0);
+        jobs.parallelFor(count, 1, [&](size_t begin, size_t) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50*(begin % 7)));
+            threads[begin] = std::this_thread::get_id();
+            results[begin] = run + 1;
+        });
+
+        size_t unfinished = 0, on_workers = 0;
+        for (size_t i = 0; i < count; i++) {
+            unfinished += (results[i] != run + 1);
+            on_workers += (threads[i] != std::this_thread::get_id());
+        }
+        CHECK(unfinished == 0);
+        if (run == 0) {
+            std::clog << jobs.threadCount() << " threads: " << on_workers << " of " << count
+                      << " chunks ran on worker threads\n";
+        }
+    }
+}
+
+static float element(size_t i) {
+    return std::sin(0.001f*static_cast<float>(i))/static_cast<float>(i + 1);
+}
+
+/// Deterministic mode must give the same bits as the sequential loop,
+/// even for a sum whose rounding depends on the order of the additions.
+static void checkDeterministic(JobSystem& jobs) {
+    constexpr size_t count = 100003;
+    float expected = 0.f;
+    for (size_t i = 0; i < count; i++) {
+        expected += element(i);
+    }
+
+    jobs.setDeterministic(true);
+    CHECK(jobs.isDeterministic());
+    for (size_t chunk_size : {size_t(1), size_t(1000), size_t(4096)}) {
+        float sum = 0.f;
+        size_t next = 0;
+        bool in_order = true;
+        std::thread::id caller = std::this_thread::get_id();
+        jobs.parallelFor(count, chunk_size, [&](size_t begin, size_t end) {
+            in_order = in_order && (begin == next) && (std::this_thread::get_id() == caller);
+            next = end;
+            for (size_t i = begin; i < end; i++) {
+                sum += element(i);
+            }
+        });
+        CHECK(in_order);
+        CHECK(next == count);
+        CHECK(std::memcmp(&sum, &expected, sizeof(float)) == 0);
+    }
+    jobs.setDeterministic(false);
+    CHECK(!jobs.isDeterministic());
+}
+
+int main() {
+    for (unsigned thread_count : {0u, 1u, 3u}) {
+        JobSystem jobs = JobSystem(thread_count);
+        CHECK(jobs.threadCount() == thread_count);
+
+        // counts that are and are not a multiple of the chunk size, and
+        // counts no larger than a chunk, which run on the calling thread
+        for (size_t count : {size_t(0), size_t(1), size_t(7), size_t(64), size_t(1000), size_t(1003)}) {
+            for (size_t chunk_size : {size_t(1), size_t(7), size_t(64), size_t(1000), size_t(2000)}) {
+                checkCoverage(jobs, count, chunk_size);
+            }
+        }
+        // a chunk size of 0 is treated as 1
+        std::atomic<size_t> calls(0);
+        jobs.parallelFor(10, 0, [&](size_t begin, size_t end) {
+            calls += (end - begin == 1);
+        });
+        CHECK(calls == 10);
+
+        checkStolenChunks(jobs);
+        checkDeterministic(jobs);
+        // back to the parallel path after deterministic mode
+        checkCoverage(jobs, 1003, 7);
+    }
+    return testResult();
+}
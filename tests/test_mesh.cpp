@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+#include "core/arena.h"
+#include "core/job_system.h"
+#include "core/mesh.h"
+#include "core/parametric.h"
+#include "test_util.h"
+
+/// A triangle as the indices of its grid points, in drawing order.
+using Triangle = std::array<int, 3>;
+
+/// Reference copy of the unindexed grid expansion the indexed meshes
+/// replaced. Every corner of every triangle is worked out on its own.
+static glm::vec2 meshgrid(int x_resolution, int y_resolution, int vertex_index) {
+    int triangle_index = vertex_index / 3; // index of the triangle
+    int triangle_vertex_index = vertex_index % 3; // label of the vertex within the triangle
+
+    int quad_index = triangle_index / 2; // index of the quad
+    int quad_triangle_index = triangle_index % 2; // label of the triangle within the quad
+
+    int column_index = quad_index / (x_resolution - 1); // index of the column
+    int row_index = quad_index % (x_resolution - 1); // index of the row
+
+    // lower left coordinate of triangle on the unit square
+    glm::vec2 unit_pos;
+    unit_pos.x = static_cast<float>(row_index)/static_cast<float>(x_resolution - 1);
+    unit_pos.y = static_cast<float>(column_index)/static_cast<float>(y_resolution - 1);
+
+    // offset for the upper right vertex
+    if (triangle_vertex_index == 1) {
+        unit_pos.x += 1.0f/static_cast<float>(x_resolution - 1);
+        unit_pos.y += 1.0f/static_cast<float>(y_resolution - 1);
+    }
+
+    // offsets for the off diagonal vertex. The spesific offset
+    // is dependent on if it is the upper or lower triangle
+    if (triangle_vertex_index == 2){
+        if (quad_triangle_index == 0) {
+            unit_pos.x += 1.0f/static_cast<float>(x_resolution - 1);
+        } else {
+            unit_pos.y += 1.0f/static_cast<float>(y_resolution - 1);
+        }
+    }
+    return unit_pos;
+}
+
+/// @return The triangles of the old expansion, with each corner snapped
+/// to the grid point it was meant to be.
+static std::vector<Triangle> referenceTriangles(int x_resolution, int y_resolution) {
+    std::vector<Triangle> triangles;
+    int num_vertices = (x_resolution - 1)*(y_resolution - 1)*2*3;
+    for (int vertex_index = 0; vertex_index < num_vertices; vertex_index += 3) {
+        Triangle triangle;
+        for (int corner = 0; corner < 3; corner++) {
+            glm::vec2 unit_pos = meshgrid(x_resolution, y_resolution, vertex_index + corner);
+            float row = unit_pos.x*static_cast<float>(x_resolution - 1);
+            float column = unit_pos.y*static_cast<float>(y_resolution - 1);
+            CHECK(std::fabs(row - std::round(row)) < 1e-3f);
+            CHECK(std::fabs(column - std::round(column)) < 1e-3f);
+            triangle[static_cast<size_t>(corner)] = static_cast<int>(std::round(column))*x_resolution + static_cast<int>(std::round(row));
+        }
+        triangles.push_back(triangle);
+    }
+    return triangles;
+}
+
+/// @return The triangles of an indexed grid mesh, after checking that
+/// every vertex holds its own grid point.
+static std::vector<Triangle> meshTriangles(const Mesh& mesh, int x_resolution, int y_resolution) {
+    for (int index = 0; index < mesh.m_vertexCount; index++) {
+        glm::vec2 expected = gridPoint(x_resolution, y_resolution, index % x_resolution, index / x_resolution);
+        const GLfloat* vertex = mesh.m_vertices + 6*index;
+        CHECK(!std::isnan(vertex[0]) && !std::isnan(vertex[1]));
+        CHECK((vertex[0] == expected.x) && (vertex[1] == expected.y));
+    }
+
+    std::vector<Triangle> triangles;
+    for (int i = 0; i < mesh.m_indexCount; i += 3) {
+        Triangle triangle;
+        for (int corner = 0; corner < 3; corner++) {
+            size_t position = static_cast<size_t>(i + corner);
+            if (mesh.m_indexType == GL_UNSIGNED_SHORT) {
+                triangle[static_cast<size_t>(corner)] = static_cast<const GLushort*>(mesh.m_indices)[position];
+            } else {
+                triangle[static_cast<size_t>(corner)] = static_cast<int>(static_cast<const GLuint*>(mesh.m_indices)[position]);
+            }
+            CHECK(triangle[static_cast<size_t>(corner)] < mesh.m_vertexCount);
+        }
+        triangles.push_back(triangle);
+    }
+    return triangles;
+}
+
+/// Compares the triangle sets of the old and new grids, ignoring the
+/// order of the triangles but not the winding of each one.
+static void checkGrid(int x_resolution, int y_resolution, GLenum index_type) {
+    Arena arena = Arena();
+    Mesh mesh = buildGridMesh(arena, x_resolution, y_resolution, [](glm::vec2 unit_pos, glm::vec3& position, glm::vec3& color) {
+        position = glm::vec3(unit_pos.x, unit_pos.y, 0.f);
+        color = glm::vec3(0.f);
+    });
+    CHECK(mesh.m_vertexCount == x_resolution*y_resolution);
+    CHECK(mesh.m_indexType == index_type);
+
+    std::vector<Triangle> expected = referenceTriangles(x_resolution, y_resolution);
+    std::vector<Triangle> actual = meshTriangles(mesh, x_resolution, y_resolution);
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    if (!CHECK(expected == actual)) {
+        std::cerr << "  grid " << x_resolution << "x" << y_resolution << ": " << expected.size()
+                  << " reference triangles, " << actual.size() << " indexed triangles\n";
+    }
+}
+
+/// The vectorized grid must store the same points as `evaluateGrid()`,
+/// including rows that are not a multiple of four long and axes with a
+/// single point.
+static void checkParametricGrid(int x_resolution, int y_resolution, JobSystem& jobs) {
+    size_t floats = Mesh::Format::stride/sizeof(GLfloat)*static_cast<size_t>(x_resolution*y_resolution);
+    std::vector<GLfloat> expected(floats), actual(floats, NAN);
+    evaluateGrid(x_resolution, y_resolution, [](glm::vec2 unit_pos, glm::vec3& position, glm::vec3& color) {
+        position = glm::vec3(unit_pos.x, unit_pos.y, 1.f);
+        color = glm::vec3(unit_pos.y, 0.f, unit_pos.x);
+    }, expected.data());
+    evaluateParametricGrid(x_resolution, y_resolution, [](Float4 u, Float4 v, Float4 position[3], Float4 color[3]) {
+        position[0] = u;
+        position[1] = v;
+        position[2] = 1.f;
+        color[0] = v;
+        color[1] = 0.f;
+        color[2] = u;
+    }, actual.data(), jobs);
+
+    if (!CHECK(std::memcmp(expected.data(), actual.data(), floats*sizeof(GLfloat)) == 0)) {
+        std::cerr << "  parametric grid " << x_resolution << "x" << y_resolution << " differs from evaluateGrid\n";
+    }
+}
+
+int main() {
+    // 16 bit indices
+    checkGrid(2, 2, GL_UNSIGNED_SHORT);
+    checkGrid(3, 5, GL_UNSIGNED_SHORT);
+    checkGrid(32, 16, GL_UNSIGNED_SHORT);
+    checkGrid(100, 100, GL_UNSIGNED_SHORT);
+    checkGrid(255, 257, GL_UNSIGNED_SHORT);
+
+    // 32 bit indices, the first grid that does not fit 16 bits
+    checkGrid(256, 257, GL_UNSIGNED_INT);
+    checkGrid(300, 300, GL_UNSIGNED_INT);
+
+    // grids with a single row or column have no triangles
+    checkGrid(1, 1, GL_UNSIGNED_SHORT);
+    checkGrid(1, 7, GL_UNSIGNED_SHORT);
+    checkGrid(7, 1, GL_UNSIGNED_SHORT);
+    checkGrid(1, 70000, GL_UNSIGNED_INT);
+
+    JobSystem jobs = JobSystem(2);
+    for (int x_resolution : {1, 2, 4, 7, 33}) {
+        for (int y_resolution : {1, 3, 20}) {
+            checkParametricGrid(x_resolution, y_resolution, jobs);
+        }
+    }
+    return testResult();
+}
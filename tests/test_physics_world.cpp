@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "core/object.h"
+#include "core/physics_world.h"
+#include "test_util.h"
+
+constexpr size_t num_bodies = 1003;
+constexpr int num_steps = 2000;
+constexpr float timestep = 1.f/120.f;
+
+/// Fills a world with bodies thrown up and down from around the floor,
+/// so most of them bounce several times during the run. Some start
+/// below the floor, moving down and moving up.
+static void initalizeBodies(PhysicsWorld& world, std::vector<Object>& objects) {
+    for (size_t i = 0; i < num_bodies; i++) {
+        float phase = static_cast<float>(i);
+        glm::vec3 position = glm::vec3(std::sin(phase), 2.f*std::cos(0.37f*phase), 0.01f*phase);
+        glm::vec3 velocity = glm::vec3(0.3f*std::cos(phase), 8.f*std::sin(1.3f*phase), 0.5f);
+        glm::vec3 acceleration = glm::vec3(0.1f*std::sin(0.5f*phase), -9.81f, 0.f);
+        world.addBody(position, velocity, acceleration);
+
+        Object object = Object(ModelHandle());
+        object.m_position = position;
+        object.m_velocity = velocity;
+        object.m_acceleration = acceleration;
+        objects.push_back(object);
+    }
+}
+
+static bool sameBits(glm::vec3 a, glm::vec3 b) {
+    return std::memcmp(&a, &b, sizeof(glm::vec3)) == 0;
+}
+
+/// Steps the world in ranges of `chunk` bodies. Ranges narrower than a
+/// vector leave the bodies to the narrower kernels, so a chunk of 1 runs
+/// everything through the scalar loop, a chunk of 4 through the SSE
+/// kernel and the whole world through the widest kernel compiled in.
+/// @return Number of bodies that differ from `Object::update`.
+static size_t runChunked(size_t chunk, const char* name) {
+    PhysicsWorld world = PhysicsWorld();
+    std::vector<Object> objects;
+    initalizeBodies(world, objects);
+
+    size_t bounces = 0;
+    for (int step = 0; step < num_steps; step++) {
+        for (size_t begin = 0; begin < num_bodies; begin += chunk) {
+            world.step(timestep, begin, std::min(begin + chunk, num_bodies));
+        }
+        for (Object& object : objects) {
+            float velocity = object.m_velocity.y;
+            object.update(timestep);
+            bounces += (object.m_velocity.y*velocity < 0.f) && (object.m_position.y < 0.f);
+        }
+    }
+    world.buildTransforms();
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < num_bodies; i++) {
+        const Object& object = objects[i];
+        bool same = sameBits(world.getPosition(i), object.m_position) && sameBits(world.getVelocity(i), object.m_velocity)
+            && (std::memcmp(&world.m_transforms[i], &object.m_modelSpaceToWorldSpace, sizeof(glm::mat4)) == 0);
+        mismatches += !same;
+    }
+    std::clog << name << ": " << mismatches << " of " << num_bodies << " bodies differ after " << num_steps
+              << " steps with " << bounces << " floor bounces\n";
+    CHECK(bounces > num_bodies);
+    return mismatches;
+}
+
+int main() {
+#if defined(__AVX__) && (defined(__GNUC__) || defined(__clang__))
+    // the AVX build of the test only runs where the CPU can execute it
+    if (!__builtin_cpu_supports("avx")) {
+        std::clog << "AVX is not supported, skipping\n";
+        return SKIP_TEST;
+    }
+#endif
+
+    CHECK(runChunked(1, "scalar") == 0);
+#if defined(__SSE2__)
+    CHECK(runChunked(4, "SSE") == 0);
+#endif
+#if defined(__AVX__)
+    CHECK(runChunked(num_bodies, "AVX") == 0);
+#else
+    // without AVX the whole world goes through the SSE kernel
+    CHECK(runChunked(num_bodies, "widest") == 0);
+#endif
+    return testResult();
+}
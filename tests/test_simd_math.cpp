@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+
+#include "core/simd_math.h"
+#include "test_util.h"
+
+/// Number of evenly spaced inputs each sweep evaluates.
+constexpr int sweep_points = 1 << 22;
+
+/// Largest errors of a function against the double precision reference
+/// over a sweep. ULP errors are measured against the reference rounded
+/// to float.
+struct SweepError {
+    double m_absolute = 0.0;
+    double m_relative = 0.0;
+    std::int64_t m_ulp = 0;
+    /// Like `m_ulp`, but only for results of magnitude 0.5 or more.
+    std::int64_t m_ulpAboveHalf = 0;
+};
+
+static void addError(SweepError& error, float result, double reference) {
+    double absolute = std::fabs(static_cast<double>(result) - reference);
+    std::int64_t ulp = ulpDistance(result, static_cast<float>(reference));
+    error.m_absolute = std::max(error.m_absolute, absolute);
+    error.m_relative = std::max(error.m_relative, absolute/std::fabs(reference));
+    error.m_ulp = std::max(error.m_ulp, ulp);
+    if (std::fabs(reference) >= 0.5) {
+        error.m_ulpAboveHalf = std::max(error.m_ulpAboveHalf, ulp);
+    }
+}
+
+/// Evaluates `function` four inputs at a time on evenly spaced points of
+/// [first, last] and calls `check(input, results)` for every point.
+template<typename Function, typename Check>
+static void sweep(float first, float last, Function function, Check check) {
+    for (int i = 0; i < sweep_points; i += 4) {
+        float inputs[4];
+        for (int lane = 0; lane < 4; lane++) {
+            double t = static_cast<double>(i + lane)/(sweep_points - 1);
+            inputs[lane] = static_cast<float>(first + t*(static_cast<double>(last) - first));
+        }
+        float results[2][4];
+        function(Float4::load(inputs), results);
+        for (int lane = 0; lane < 4; lane++) {
+            check(inputs[lane], results[0][lane], results[1][lane]);
+        }
+    }
+}
+
+static void printError(const char* name, const SweepError& error) {
+    std::clog << name << ": absolute " << error.m_absolute << ", relative " << error.m_relative
+              << ", " << error.m_ulp << " ulp, " << error.m_ulpAboveHalf << " ulp above 0.5\n";
+}
+
+/// `simdSinCos()` promises an absolute error below 1e-7 and at most two
+/// ulp for results of magnitude 0.5 or more, for |x| <= 8192.
+static void checkSinCos(float range) {
+    SweepError sine_error, cosine_error;
+    sweep(-range, range, [](Float4 x, float results[2][4]) {
+        Float4 sine, cosine;
+        simdSinCos(x, sine, cosine);
+        sine.store(results[0]);
+        cosine.store(results[1]);
+    }, [&](float x, float sine, float cosine) {
+        addError(sine_error, sine, std::sin(static_cast<double>(x)));
+        addError(cosine_error, cosine, std::cos(static_cast<double>(x)));
+    });
+
+    std::clog << "|x| <= " << range << "\n";
+    printError("  simdSin", sine_error);
+    printError("  simdCos", cosine_error);
+    for (const SweepError& error : {sine_error, cosine_error}) {
+        CHECK(error.m_absolute < 1e-7);
+        CHECK(error.m_ulpAboveHalf <= 2);
+    }
+}
+
+/// `simdExp()` promises a relative error below 1.5e-7 and at most one
+/// ulp for x in [-87, 88].
+static void checkExp() {
+    SweepError error;
+    sweep(-87.f, 88.f, [](Float4 x, float results[2][4]) {
+        simdExp(x).store(results[0]);
+        Float4(0.f).store(results[1]);
+    }, [&](float x, float result, float) {
+        addError(error, result, std::exp(static_cast<double>(x)));
+    });
+
+    printError("simdExp", error);
+    CHECK(error.m_relative < 1.5e-7);
+    CHECK(error.m_ulp <= 1);
+
+    // inputs outside the range are clamped to it
+    const float inputs[4] = {-1000.f, -88.f, 89.f, 1000.f};
+    float results[4];
+    simdExp(Float4::load(inputs)).store(results);
+    for (float result : results) {
+        CHECK(std::isfinite(result) && (result >= FLT_MIN));
+    }
+}
+
+int main() {
+    // the small range checks the polynomials on their own, the large one
+    // the argument reduction as well
+    checkSinCos(8.f);
+    checkSinCos(8192.f);
+    checkExp();
+    return testResult();
+}
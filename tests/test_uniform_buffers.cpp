@@ -0,0 +1,107 @@
+#include <cstring>
+#include <vector>
+
+// keep this before all other OpenGL libraries
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "core/headless_context.h"
+#include "core/uniform_buffers.h"
+#include "test_util.h"
+
+/// Room for only a few draws, so every frame outgrows the ring.
+constexpr size_t max_draws = 4;
+constexpr int num_frames = 5;
+
+/// A draw block that no other draw of the run shares.
+static DrawBlock makeDraw(int frame, size_t index) {
+    DrawBlock draw = DrawBlock();
+    draw.m_modelSpaceToWorldSpace = glm::mat4(1.f);
+    draw.m_modelSpaceToWorldSpace[3] = glm::vec4(static_cast<float>(frame), static_cast<float>(index), 0.f, 1.f);
+    draw.m_instanced = static_cast<GLint>(index);
+    return draw;
+}
+
+/// Reads back the range bound to `DRAW_BINDING`, what the programs see.
+static bool boundDrawIs(const DrawBlock& expected) {
+    GLint buffer = 0;
+    GLint64 start = 0, size = 0;
+    glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING, UniformBuffers::DRAW_BINDING, &buffer);
+    glGetInteger64i_v(GL_UNIFORM_BUFFER_START, UniformBuffers::DRAW_BINDING, &start);
+    glGetInteger64i_v(GL_UNIFORM_BUFFER_SIZE, UniformBuffers::DRAW_BINDING, &size);
+    if ((buffer == 0) || (size != static_cast<GLint64>(sizeof(DrawBlock)))) {
+        return false;
+    }
+
+    DrawBlock bound;
+    glBindBuffer(GL_COPY_READ_BUFFER, static_cast<GLuint>(buffer));
+    glGetBufferSubData(GL_COPY_READ_BUFFER, static_cast<GLintptr>(start), sizeof(DrawBlock), &bound);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    return std::memcmp(&bound, &expected, sizeof(DrawBlock)) == 0;
+}
+
+int main() {
+    HeadlessContext context = HeadlessContext();
+    if (!context.create(64, 64)) {
+        std::clog << "No OpenGL context, skipping\n";
+        return SKIP_TEST;
+    }
+    // the headless context has a core profile, which GLEW only fully
+    // loads in experimental mode
+    glewExperimental = GL_TRUE;
+    GLenum glew_status = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // GLEW built for GLX finds no X display when the context comes from
+    // EGL, the core OpenGL functions are loaded regardless
+    if (glew_status == GLEW_ERROR_NO_GLX_DISPLAY) {
+        glew_status = GLEW_OK;
+    }
+#endif
+    if (glew_status != GLEW_OK) {
+        std::clog << "Failed to initialize GLEW, skipping\n";
+        context.release();
+        return SKIP_TEST;
+    }
+
+    UniformBuffers uniforms = UniformBuffers(max_draws);
+    uniforms.setCamera(CameraBlock());
+    size_t mismatches = 0, checks = 0;
+    for (int frame = 0; frame < num_frames; frame++) {
+        // more draws every frame, each past the size the ring has grown to
+        size_t count = (max_draws << frame) + 1;
+        std::vector<size_t> indices;
+
+        // the render queue adds every draw before binding any of them
+        for (size_t i = 0; i < count; i++) {
+            indices.push_back(uniforms.addDraw(makeDraw(frame, i)));
+        }
+        uniforms.flush();
+        for (size_t i = 0; i < count; i++) {
+            uniforms.bindDraw(indices[i]);
+            mismatches += !boundDrawIs(makeDraw(frame, i));
+        }
+
+        // the batch renderer binds each draw as soon as it is added,
+        // while the earlier ones must stay where they are
+        for (size_t i = count; i < 2*count; i++) {
+            indices.push_back(uniforms.addDraw(makeDraw(frame, i)));
+            uniforms.flush();
+            uniforms.bindDraw(indices[i]);
+            mismatches += !boundDrawIs(makeDraw(frame, i));
+        }
+        for (size_t i = 0; i < 2*count; i++) {
+            uniforms.bindDraw(indices[i]);
+            mismatches += !boundDrawIs(makeDraw(frame, i));
+        }
+        checks += 4*count;
+        uniforms.lockRegions();
+    }
+    std::clog << mismatches << " of " << checks << " bound draw blocks differ\n";
+    CHECK(mismatches == 0);
+    CHECK(glGetError() == GL_NO_ERROR);
+
+    uniforms.releaseBuffers();
+    context.release();
+    return testResult();
+}
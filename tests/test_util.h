@@ -0,0 +1,50 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+/// Exit code that tells ctest the test was skipped, for tests that need
+/// hardware or drivers the machine may not have.
+constexpr int SKIP_TEST = 77;
+
+/// Number of checks that failed so far.
+inline int test_failures = 0;
+
+/// Prints the check if it failed and counts it, see `CHECK`.
+/// @return The condition.
+inline bool checkCondition(bool condition, const char* expression, const char* file, int line) {
+    if (!condition) {
+        std::cerr << file << ":" << line << ": check failed: " << expression << "\n";
+        test_failures++;
+    }
+    return condition;
+}
+
+/// Checks a condition without stopping the test, so every failure of a
+/// run is reported.
+#define CHECK(condition) checkCondition((condition), #condition, __FILE__, __LINE__)
+
+/// @return Number of representable floats from `a` to `b`, 0 if they
+/// are equal and 1 if they are neighbours, across zero as well.
+inline std::int64_t ulpDistance(float a, float b) {
+    std::int32_t a_bits, b_bits;
+    std::memcpy(&a_bits, &a, sizeof(a_bits));
+    std::memcpy(&b_bits, &b, sizeof(b_bits));
+    // maps the sign and magnitude bits onto a line of consecutive integers
+    std::int64_t a_order = (a_bits < 0) ? -std::int64_t(a_bits & 0x7FFFFFFF) : a_bits;
+    std::int64_t b_order = (b_bits < 0) ? -std::int64_t(b_bits & 0x7FFFFFFF) : b_bits;
+    return (a_order > b_order) ? a_order - b_order : b_order - a_order;
+}
+
+/// @return Exit code of the test, nonzero if any check failed.
+inline int testResult() {
+    if (test_failures > 0) {
+        std::cerr << test_failures << " checks failed\n";
+        return 1;
+    }
+    return 0;
+}
+
+#endif